@@ -0,0 +1,268 @@
+#include "AssetPack.h"
+#include <stdio.h>
+#include <string.h>
+#include <new>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+
+/* CRC-32 (as in zip and PNG), a byte at a time from a table
+built on first use. */
+struct CRC_TABLE
+{
+	CRC_TABLE()
+	{
+		for( unsigned int n = 0; n < 256; n++ )
+		{
+			unsigned int c = n;
+			for( int k = 0; k < 8; k++ )
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			this->Values[n] = c;
+		}
+	}
+
+	unsigned int Values[256];
+};
+unsigned int CAssetPack::Checksum(const void * pData, unsigned long long Size)
+{
+	static const CRC_TABLE Table;
+
+	const unsigned char * p = (const unsigned char *)pData;
+	unsigned int c = 0xFFFFFFFFu;
+	for( unsigned long long i = 0; i < Size; i++ )
+		c = Table.Values[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+	return c ^ 0xFFFFFFFFu;
+}
+
+
+
+CAssetPack::CAssetPack()
+{
+	this->pBase = nullptr;
+	this->Size = 0;
+	this->pEntries = nullptr;
+	this->EntryCount = 0;
+}
+CAssetPack::~CAssetPack()
+{
+	this->Close();
+}
+bool CAssetPack::Open(const char * szFileName)
+{
+	this->Close();
+
+	// Map the whole file
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA( szFileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL );
+	if( hFile == INVALID_HANDLE_VALUE ) return false;
+	LARGE_INTEGER FileSize;
+	HANDLE hMapping = NULL;
+	if( GetFileSizeEx( hFile, &FileSize ) && FileSize.QuadPart > 0 )
+		hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	CloseHandle( hFile );
+	if( !hMapping ) return false;
+	// The view keeps the mapping open
+	const void * pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+	CloseHandle( hMapping );
+	if( !pView ) return false;
+	unsigned long long MappedSize = (unsigned long long)FileSize.QuadPart;
+#else
+	int File = open( szFileName, O_RDONLY );
+	if( File < 0 ) return false;
+	struct stat Stat;
+	void * pView = MAP_FAILED;
+	if( fstat( File, &Stat ) == 0 && Stat.st_size > 0 )
+		pView = mmap( nullptr, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, File, 0 );
+	close( File );
+	if( pView == MAP_FAILED ) return false;
+	unsigned long long MappedSize = (unsigned long long)Stat.st_size;
+#endif
+	this->pBase = (const unsigned char *)pView;
+	this->Size = MappedSize;
+
+	// Check the header and the table of contents
+	const ASSET_PACK_HEADER * pHeader = (const ASSET_PACK_HEADER *)this->pBase;
+	if( this->Size < sizeof(ASSET_PACK_HEADER) ||
+		pHeader->Magic != ASSET_PACK_MAGIC ||
+		pHeader->Version != ASSET_PACK_VERSION ||
+		!pHeader->Alignment || (pHeader->Alignment & (pHeader->Alignment - 1)) ||
+		pHeader->EntryCount > (this->Size - sizeof(ASSET_PACK_HEADER)) / sizeof(ASSET_PACK_ENTRY) )
+	{
+		this->Close();
+		return false;
+	}
+	const ASSET_PACK_ENTRY * pEntries = (const ASSET_PACK_ENTRY *)(this->pBase + sizeof(ASSET_PACK_HEADER));
+	if( Checksum( pEntries, (unsigned long long)pHeader->EntryCount*sizeof(ASSET_PACK_ENTRY) ) != pHeader->TocChecksum )
+	{
+		this->Close();
+		return false;
+	}
+	for( unsigned int i = 0; i < pHeader->EntryCount; i++ )
+	{
+		const ASSET_PACK_ENTRY &Entry = pEntries[i];
+		if( ( i && Entry.Id <= pEntries[i-1].Id ) ||
+			Entry.Offset % pHeader->Alignment ||
+			Entry.Size > 0xFFFFFFFFu ||
+			Entry.Offset > this->Size || Entry.Size > this->Size - Entry.Offset )
+		{
+			this->Close();
+			return false;
+		}
+	}
+	this->pEntries = pEntries;
+	this->EntryCount = pHeader->EntryCount;
+
+	return true;
+}
+void CAssetPack::Close()
+{
+	if( this->pBase )
+	{
+#ifdef _WIN32
+		UnmapViewOfFile( this->pBase );
+#else
+		munmap( (void *)this->pBase, (size_t)this->Size );
+#endif
+	}
+	this->pBase = nullptr;
+	this->Size = 0;
+	this->pEntries = nullptr;
+	this->EntryCount = 0;
+}
+bool CAssetPack::IsOpen()
+{
+	return this->pBase != nullptr;
+}
+unsigned int CAssetPack::GetEntryCount()
+{
+	return this->EntryCount;
+}
+bool CAssetPack::Find(unsigned int Id, ASSET_SPAN * pOut)
+{
+	const ASSET_PACK_ENTRY * pEnd = this->pEntries + this->EntryCount;
+	const ASSET_PACK_ENTRY * pEntry = std::lower_bound( this->pEntries, pEnd, Id,
+		[](const ASSET_PACK_ENTRY &Entry, unsigned int Id) { return Entry.Id < Id; } );
+	if( pEntry == pEnd || pEntry->Id != Id )
+		return false;
+
+	pOut->pData = this->pBase + pEntry->Offset;
+	pOut->Size = (unsigned int)pEntry->Size;
+	pOut->Checksum = pEntry->Checksum;
+
+	return true;
+}
+bool CAssetPack::Verify(const ASSET_SPAN * pSpan)
+{
+	return Checksum( pSpan->pData, pSpan->Size ) == pSpan->Checksum;
+}
+
+
+
+CAssetPackWriter::CAssetPackWriter()
+{
+	this->pAssets = nullptr;
+	this->Count = 0;
+	this->Capacity = 0;
+}
+CAssetPackWriter::~CAssetPackWriter()
+{
+	delete[] this->pAssets;
+}
+bool CAssetPackWriter::Add(unsigned int Id, const void * pData, unsigned int Size)
+{
+	if( this->Count == this->Capacity )
+	{
+		unsigned int NewCapacity = this->Capacity ? this->Capacity*2 : 32;
+		ASSET * pNewAssets = new(std::nothrow) ASSET[NewCapacity];
+		if( !pNewAssets ) return false;
+		for( unsigned int i = 0; i < this->Count; i++ )
+			pNewAssets[i] = this->pAssets[i];
+		delete[] this->pAssets;
+		this->pAssets = pNewAssets;
+		this->Capacity = NewCapacity;
+	}
+
+	ASSET &Asset = this->pAssets[this->Count++];
+	Asset.Id = Id;
+	Asset.pData = pData;
+	Asset.Size = Size;
+
+	return true;
+}
+bool CAssetPackWriter::Write(const char * szFileName, unsigned int Alignment)
+{
+	if( !Alignment || (Alignment & (Alignment - 1)) )
+		return false;
+
+	// The table of contents is sorted, and each ID is only in it once
+	std::sort( this->pAssets, this->pAssets + this->Count,
+		[](const ASSET &a, const ASSET &b) { return a.Id < b.Id; } );
+	for( unsigned int i = 1; i < this->Count; i++ )
+		if( this->pAssets[i].Id == this->pAssets[i-1].Id )
+			return false;
+
+	ASSET_PACK_ENTRY * pEntries = new(std::nothrow) ASSET_PACK_ENTRY[this->Count ? this->Count : 1];
+	if( !pEntries ) return false;
+
+	// Lay the data out after the table of contents
+	unsigned long long Offset = sizeof(ASSET_PACK_HEADER) + (unsigned long long)this->Count*sizeof(ASSET_PACK_ENTRY);
+	for( unsigned int i = 0; i < this->Count; i++ )
+	{
+		Offset = (Offset + Alignment - 1) & ~(unsigned long long)(Alignment - 1);
+		pEntries[i].Id = this->pAssets[i].Id;
+		pEntries[i].Checksum = CAssetPack::Checksum( this->pAssets[i].pData, this->pAssets[i].Size );
+		pEntries[i].Offset = Offset;
+		pEntries[i].Size = this->pAssets[i].Size;
+		Offset += this->pAssets[i].Size;
+	}
+
+	ASSET_PACK_HEADER Header;
+	Header.Magic = ASSET_PACK_MAGIC;
+	Header.Version = ASSET_PACK_VERSION;
+	Header.EntryCount = this->Count;
+	Header.Alignment = Alignment;
+	Header.TocChecksum = CAssetPack::Checksum( pEntries, (unsigned long long)this->Count*sizeof(ASSET_PACK_ENTRY) );
+	Header.Reserved = 0;
+
+	FILE * pFile = fopen( szFileName, "wb" );
+	bool Written = pFile != nullptr;
+	if( pFile )
+	{
+		Written = fwrite( &Header, sizeof(Header), 1, pFile ) == 1;
+		if( Written && this->Count )
+			Written = fwrite( pEntries, sizeof(ASSET_PACK_ENTRY), this->Count, pFile ) == this->Count;
+
+		// Pad each asset out to its offset
+		static const char Zeros[64] = { 0 };
+		unsigned long long Position = sizeof(ASSET_PACK_HEADER) + (unsigned long long)this->Count*sizeof(ASSET_PACK_ENTRY);
+		for( unsigned int i = 0; Written && i < this->Count; i++ )
+		{
+			while( Written && Position < pEntries[i].Offset )
+			{
+				size_t Padding = (size_t)std::min<unsigned long long>( pEntries[i].Offset - Position, sizeof(Zeros) );
+				Written = fwrite( Zeros, 1, Padding, pFile ) == Padding;
+				Position += Padding;
+			}
+			if( Written && this->pAssets[i].Size )
+				Written = fwrite( this->pAssets[i].pData, this->pAssets[i].Size, 1, pFile ) == 1;
+			Position += this->pAssets[i].Size;
+		}
+
+		if( fclose( pFile ) != 0 )
+			Written = false;
+	}
+
+	delete[] pEntries;
+
+	return Written;
+}
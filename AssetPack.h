@@ -0,0 +1,104 @@
+#pragma once
+
+/* The pack format is described with fixed-size integer types
+rather than DWORD and friends, so that a build tool can write
+packs without the Windows headers; only the mapping of the
+file in AssetPack.cpp differs between platforms. */
+
+
+
+/* An asset pack is one file holding the assets of the game,
+each under a numeric ID (the IDR_RSRC_ values of Resource.h).
+It begins with an ASSET_PACK_HEADER, followed by the table of
+contents: one ASSET_PACK_ENTRY per asset, sorted by ID. The
+data of each asset starts at an offset which is a multiple of
+the alignment given in the header. Every field is little-
+endian. The table of contents and the data of each asset
+carry a CRC-32, so that damage to the file can be found. */
+#define ASSET_PACK_MAGIC		0x4B50574D // "MWPK"
+#define ASSET_PACK_VERSION		1
+#define ASSET_PACK_ALIGNMENT	16
+
+struct ASSET_PACK_HEADER
+{
+	unsigned int Magic;
+	unsigned int Version;
+	unsigned int EntryCount;
+	unsigned int Alignment; // Of the data of each entry, a power of two
+	unsigned int TocChecksum; // CRC-32 of the entries
+	unsigned int Reserved;
+};
+struct ASSET_PACK_ENTRY
+{
+	unsigned int Id;
+	unsigned int Checksum; // CRC-32 of the data
+	unsigned long long Offset; // From the start of the pack
+	unsigned long long Size; // Bytes
+};
+
+/* A view of the data of one asset, inside the mapping of
+the pack; nothing is copied. It stays valid until the pack
+is closed. */
+struct ASSET_SPAN
+{
+	const unsigned char * pData;
+	unsigned int Size;
+	unsigned int Checksum; // As recorded in the pack
+};
+
+
+
+/* CAssetPack maps a pack into memory, read-only. Open checks
+the header and the table of contents, but no asset data, so
+only the pages of the assets that are read are ever loaded
+from the disk. Find looks an ID up with a binary search; it
+does not check the data, which Verify does (reading all of
+it in). Once open, a pack may be read from any thread. */
+class CAssetPack
+{
+public:
+	CAssetPack();
+	~CAssetPack();
+
+	bool Open(const char * szFileName);
+	void Close();
+	bool IsOpen();
+
+	unsigned int GetEntryCount();
+	bool Find(unsigned int Id, ASSET_SPAN * pOut);
+	static bool Verify(const ASSET_SPAN * pSpan);
+
+	static unsigned int Checksum(const void * pData, unsigned long long Size);
+
+private:
+	const unsigned char * pBase;
+	unsigned long long Size;
+	const ASSET_PACK_ENTRY * pEntries;
+	unsigned int EntryCount;
+};
+
+
+
+/* CAssetPackWriter collects assets and writes them out as a
+pack. Add keeps the pointer it is given, not a copy, so the
+data must stay valid until Write has returned. */
+class CAssetPackWriter
+{
+public:
+	CAssetPackWriter();
+	~CAssetPackWriter();
+
+	bool Add(unsigned int Id, const void * pData, unsigned int Size);
+	bool Write(const char * szFileName, unsigned int Alignment);
+
+private:
+	struct ASSET
+	{
+		unsigned int Id;
+		const void * pData;
+		unsigned int Size;
+	};
+	ASSET * pAssets;
+	unsigned int Count;
+	unsigned int Capacity;
+};
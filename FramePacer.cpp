@@ -0,0 +1,156 @@
+#include "FramePacer.h"
+#include <math.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <MMSystem.h>
+#pragma comment(lib, "winmm.lib")
+#else
+#include <time.h>
+#endif
+
+
+
+#ifdef _WIN32
+unsigned long long CTimer::Now()
+{
+	LARGE_INTEGER Count;
+	QueryPerformanceCounter( &Count );
+	return (unsigned long long)Count.QuadPart;
+}
+unsigned long long CTimer::Frequency()
+{
+	LARGE_INTEGER Frequency;
+	QueryPerformanceFrequency( &Frequency );
+	return (unsigned long long)Frequency.QuadPart;
+}
+void CTimer::Sleep(unsigned int Milliseconds)
+{
+	::Sleep( Milliseconds );
+}
+#else
+unsigned long long CTimer::Now()
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (unsigned long long)ts.tv_sec*1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+unsigned long long CTimer::Frequency()
+{
+	return 1000000000ULL;
+}
+void CTimer::Sleep(unsigned int Milliseconds)
+{
+	struct timespec ts;
+	ts.tv_sec = Milliseconds / 1000;
+	ts.tv_nsec = long(Milliseconds % 1000) * 1000000L;
+	while( nanosleep( &ts, &ts ) != 0 );
+}
+#endif
+
+
+
+CFramePacer::CFramePacer()
+{
+#ifdef _WIN32
+	// Sleep in 1ms steps rather than the default 15.6ms
+	timeBeginPeriod( 1 );
+#endif
+	this->Frequency = CTimer::Frequency();
+	this->Period = 0;
+	this->Deadline = 0;
+	this->TargetRate = 0;
+	this->SetSpinMargin( 0.002 );
+	this->ResetStats();
+}
+CFramePacer::~CFramePacer()
+{
+#ifdef _WIN32
+	timeEndPeriod( 1 );
+#endif
+}
+void CFramePacer::SetTargetRate(unsigned int FramesPerSecond)
+{
+	this->TargetRate = FramesPerSecond;
+	this->Period = FramesPerSecond ? this->Frequency / FramesPerSecond : 0;
+	this->Deadline = 0;
+}
+void CFramePacer::SetSpinMargin(double Seconds)
+{
+	this->SpinMargin = (unsigned long long)( Seconds * double(this->Frequency) );
+}
+void CFramePacer::Wait()
+{
+	if( !this->Period )
+		return;
+
+	unsigned long long Now = CTimer::Now();
+	if( !this->Deadline )
+	{
+		// First frame; nothing to wait for yet
+		this->Deadline = Now + this->Period;
+		return;
+	}
+
+	// Sleep while the deadline is further away than the margin
+	if( Now + this->SpinMargin < this->Deadline )
+	{
+		unsigned long long Counts = this->Deadline - this->SpinMargin - Now;
+		unsigned int Milliseconds = (unsigned int)( Counts*1000 / this->Frequency );
+		if( Milliseconds )
+			CTimer::Sleep( Milliseconds );
+	}
+
+	// Spin for the rest
+	do Now = CTimer::Now();
+	while( Now < this->Deadline );
+
+	double Jitter = double(Now - this->Deadline) / double(this->Frequency);
+	this->FrameCount ++;
+	this->JitterSum += Jitter;
+	this->JitterSquareSum += Jitter*Jitter;
+	if( Jitter > this->JitterMax )
+		this->JitterMax = Jitter;
+
+	if( Now - this->Deadline >= this->Period )
+	{
+		this->OverrunCount ++;
+		this->Deadline = Now + this->Period;
+	}
+	else this->Deadline += this->Period;
+}
+void CFramePacer::ResetStats()
+{
+	this->FrameCount = 0;
+	this->OverrunCount = 0;
+	this->JitterSum = 0.0;
+	this->JitterSquareSum = 0.0;
+	this->JitterMax = 0.0;
+}
+unsigned int CFramePacer::GetTargetRate()
+{
+	return this->TargetRate;
+}
+unsigned int CFramePacer::GetFrameCount()
+{
+	return this->FrameCount;
+}
+unsigned int CFramePacer::GetOverrunCount()
+{
+	return this->OverrunCount;
+}
+double CFramePacer::GetMeanJitter()
+{
+	return this->FrameCount ? this->JitterSum / double(this->FrameCount) : 0.0;
+}
+double CFramePacer::GetMaxJitter()
+{
+	return this->JitterMax;
+}
+double CFramePacer::GetJitterDeviation()
+{
+	if( !this->FrameCount ) return 0.0;
+	double Mean = this->GetMeanJitter();
+	double Variance = this->JitterSquareSum / double(this->FrameCount) - Mean*Mean;
+	return Variance > 0.0 ? sqrt( Variance ) : 0.0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+/* FramePacer.h only depends on the C++ standard library (and
+on Windows.h when built for Windows), so that the pacer can
+be built and checked on other platforms too. */
+
+
+
+/* CTimer reads a monotonic clock and sleeps the calling thread.
+On Windows it uses the performance counter; elsewhere it uses
+clock_gettime and nanosleep. */
+class CTimer
+{
+public:
+	static unsigned long long Now(); // Clock counts
+	static unsigned long long Frequency(); // Counts per second
+	static void Sleep(unsigned int Milliseconds);
+};
+
+
+
+/* CFramePacer holds a loop to a target frame rate. Wait blocks
+until the deadline of the current frame: it sleeps until
+'SpinMargin' seconds before the deadline (sleeps can overrun by
+a scheduler quantum), then spins on the clock for the rest.
+If a frame overruns by a whole period, the deadlines restart
+from the current time instead of rushing to catch up.
+Every Wait records how late it returned against the deadline,
+which is the pacing jitter. A target rate of zero disables
+pacing; Wait then returns at once. */
+class CFramePacer
+{
+public:
+	CFramePacer();
+	~CFramePacer();
+
+	void SetTargetRate(unsigned int FramesPerSecond);
+	void SetSpinMargin(double Seconds);
+	void Wait();
+	void ResetStats();
+
+	unsigned int GetTargetRate();
+	unsigned int GetFrameCount(); // Frames waited for since ResetStats
+	unsigned int GetOverrunCount(); // Frames that missed a whole period
+	double GetMeanJitter(); // Seconds
+	double GetMaxJitter();
+	double GetJitterDeviation();
+
+private:
+	unsigned long long Frequency;
+	unsigned long long Period; // Counts per frame, or 0
+	unsigned long long SpinMargin; // Counts
+	unsigned long long Deadline; // Clock count, or 0 before the first frame
+	unsigned int TargetRate;
+	unsigned int FrameCount;
+	unsigned int OverrunCount;
+	double JitterSum;
+	double JitterSquareSum;
+	double JitterMax;
+};
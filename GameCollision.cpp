@@ -0,0 +1,369 @@
+
+
+
+#include "GameCollision.h"
+#include <new>
+#include <math.h>
+#include <intrin.h>
+
+
+
+/* POPCNT arrived after SSE2, so it has to be detected; the
+fallback counts the bits of a word in parallel. */
+static bool IsPOPCNTSupported()
+{
+	int Info[4];
+	__cpuid( Info, 1 );
+	return (Info[2] & (1<<23)) != 0;
+}
+static const bool g_bPOPCNT = IsPOPCNTSupported();
+
+static DWORD CountBits( DWORD v )
+{
+	if( g_bPOPCNT )
+		return __popcnt( v );
+
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+
+
+void LAWN::Initialise()
+{
+	this->Bits = nullptr;
+	this->Pitch = 0;
+	this->Width = 0;
+	this->Height = 0;
+	this->CellSize = 1.0f;
+	this->OriginX = 0.0f;
+	this->OriginZ = 0.0f;
+}
+void LAWN::Destroy()
+{
+	delete[] this->Bits;
+	this->Initialise();
+}
+int LAWN::Create(DWORD Width, DWORD Height, float CellSize)
+{
+	if( !Width || !Height || CellSize <= 0.0f )
+		return E_INVALIDARG;
+
+	// Reallocate only when the lawn has changed size
+	DWORD Pitch = (Width + 31) >> 5;
+	if( Pitch*Height != this->Pitch*this->Height )
+	{
+		delete[] this->Bits;
+		this->Bits = new(std::nothrow) DWORD[Pitch*Height];
+		if( !this->Bits ) { this->Initialise(); return E_OUTOFMEMORY; }
+	}
+	this->Pitch = Pitch;
+	this->Width = Width;
+	this->Height = Height;
+	this->CellSize = CellSize;
+	this->OriginX = -0.5f*CellSize*float(Width-1);
+	this->OriginZ = -0.5f*CellSize*float(Height-1);
+	memset( this->Bits, 0, Pitch*Height*sizeof(DWORD) );
+
+	return S_OK;
+}
+DWORD LAWN::Cut(float X, float Z, float MoveX, float MoveZ, float Extents)
+{
+	if( !this->Bits )
+		return 0;
+
+	// Only the rows under the box around the whole path
+	float fInvSize = 1.0f/this->CellSize;
+	float MinZ = (MoveZ < 0.0f ? Z+MoveZ : Z) - Extents;
+	float MaxZ = (MoveZ < 0.0f ? Z : Z+MoveZ) + Extents;
+	float fFirstZ = ceilf( (MinZ - this->OriginZ)*fInvSize );
+	float fLastZ = floorf( (MaxZ - this->OriginZ)*fInvSize );
+	if( fLastZ < 0.0f || fFirstZ >= float(this->Height) )
+		return 0;
+	DWORD FirstZ = fFirstZ > 0.0f ? DWORD(fFirstZ) : 0;
+	DWORD LastZ = fLastZ < float(this->Height-1) ? DWORD(fLastZ) : this->Height-1;
+
+	DWORD n = 0;
+	for( DWORD z = FirstZ; z <= LastZ; z++ )
+	{
+		/* The box covers the row while its centre is within
+		'Extents' of it along Z. Over that time the centre
+		moves linearly along X, so the run of tiles covered is
+		bounded by where the centre is at either end. */
+		float PointZ = this->GetTileZ( z );
+		float t0 = 0.0f, t1 = 1.0f;
+		if( MoveZ != 0.0f )
+		{
+			t0 = (PointZ - Extents - Z) / MoveZ;
+			t1 = (PointZ + Extents - Z) / MoveZ;
+			if( t0 > t1 ) { float t = t0; t0 = t1; t1 = t; }
+			if( t0 < 0.0f ) t0 = 0.0f;
+			if( t1 > 1.0f ) t1 = 1.0f;
+			if( t0 > t1 ) continue;
+		}
+		else if( fabsf( PointZ - Z ) > Extents )
+			continue;
+
+		float X0 = X + MoveX*t0, X1 = X + MoveX*t1;
+		float MinX = (X0 < X1 ? X0 : X1) - Extents;
+		float MaxX = (X0 < X1 ? X1 : X0) + Extents;
+		float fFirstX = ceilf( (MinX - this->OriginX)*fInvSize );
+		float fLastX = floorf( (MaxX - this->OriginX)*fInvSize );
+		if( fLastX < 0.0f || fFirstX >= float(this->Width) || fFirstX > fLastX )
+			continue;
+		DWORD FirstX = fFirstX > 0.0f ? DWORD(fFirstX) : 0;
+		DWORD LastX = fLastX < float(this->Width-1) ? DWORD(fLastX) : this->Width-1;
+
+		// Set the run one word at a time
+		DWORD *pRow = this->Bits + z*this->Pitch;
+		for( DWORD w = FirstX >> 5; w <= LastX >> 5; w++ )
+		{
+			DWORD Mask = 0xFFFFFFFF;
+			if( w == FirstX >> 5 ) Mask &= 0xFFFFFFFF << (FirstX & 31);
+			if( w == LastX >> 5 ) Mask &= 0xFFFFFFFF >> (31 - (LastX & 31));
+
+			n += CountBits( Mask & ~pRow[w] );
+			pRow[w] |= Mask;
+		}
+	}
+
+	return n;
+}
+DWORD LAWN::CountCut()
+{
+	DWORD n = 0;
+	for( DWORD i = 0; i < this->Pitch*this->Height; i++ )
+		n += CountBits( this->Bits[i] );
+	return n;
+}
+
+
+
+bool SweepBoxPoint( float X, float Z, float MoveX, float MoveZ, float Extents,
+	float PointX, float PointZ, float & Toi )
+{
+	/* The box covers the point while the centre is within
+	'Extents' of it on both axes. Each axis gives an interval
+	of time; the box covers the point where they overlap. */
+	float Enter = 0.0f, Exit = 1.0f;
+
+	float Start[2] = { X, Z }, Move[2] = { MoveX, MoveZ }, Point[2] = { PointX, PointZ };
+	for( DWORD a = 0; a < 2; a++ )
+	{
+		float Lo = Point[a] - Extents - Start[a];
+		float Hi = Point[a] + Extents - Start[a];
+		if( Move[a] == 0.0f )
+		{
+			// Not moving along this axis; it is either always or never in range
+			if( Lo > 0.0f || Hi < 0.0f ) return false;
+			continue;
+		}
+
+		float t0 = Lo / Move[a], t1 = Hi / Move[a];
+		if( t0 > t1 ) { float t = t0; t0 = t1; t1 = t; }
+		if( t0 > Enter ) Enter = t0;
+		if( t1 < Exit ) Exit = t1;
+		if( Enter > Exit ) return false;
+	}
+
+	Toi = Enter;
+	return true;
+}
+
+
+
+template <typename T>
+static bool GrowArray( T *& pArray, DWORD Count, DWORD NewCapacity )
+{
+	T * pNew = new(std::nothrow) T[NewCapacity];
+	if( !pNew ) return false;
+	if( pArray )
+	{
+		memcpy( pNew, pArray, Count*sizeof(T) );
+		delete[] pArray;
+	}
+	pArray = pNew;
+	return true;
+}
+
+#define SAP_MAX_END 0x80000000
+
+void SWEEP_AND_PRUNE::Initialise()
+{
+	this->Proxies = nullptr;
+	this->ProxyCount = 0;
+	this->ProxyCapacity = 0;
+	this->KeyProxy = nullptr;
+	this->KeyCapacity = 0;
+	this->Endpoints = nullptr;
+	this->Active = nullptr;
+	this->Remap = nullptr;
+	this->Pairs = nullptr;
+	this->PairCount = 0;
+	this->PairCapacity = 0;
+	this->Stamp = 1;
+}
+void SWEEP_AND_PRUNE::Destroy()
+{
+	delete[] this->Proxies;
+	delete[] this->KeyProxy;
+	delete[] this->Endpoints;
+	delete[] this->Active;
+	delete[] this->Remap;
+	delete[] this->Pairs;
+	this->Initialise();
+}
+int SWEEP_AND_PRUNE::SetProxy(DWORD Key, void * pUser, bool bMover, float MinX, float MaxX, float MinZ, float MaxZ)
+{
+	// Make room for the key
+	if( Key >= this->KeyCapacity )
+	{
+		DWORD dwNewSize = this->KeyCapacity ? this->KeyCapacity : 64;
+		while( dwNewSize <= Key ) dwNewSize *= 2;
+		if( !GrowArray( this->KeyProxy, this->KeyCapacity, dwNewSize ) )
+			return E_OUTOFMEMORY;
+		for( DWORD i = this->KeyCapacity; i < dwNewSize; i++ )
+			this->KeyProxy[i] = (DWORD)-1;
+		this->KeyCapacity = dwNewSize;
+	}
+
+	// New proxies get their endpoints at the end; Update sorts them in
+	DWORD dwProxy = this->KeyProxy[Key];
+	if( dwProxy == (DWORD)-1 )
+	{
+		if( this->ProxyCount == this->ProxyCapacity )
+		{
+			DWORD dwNewSize = this->ProxyCapacity ? this->ProxyCapacity*2 : 64;
+			if( !GrowArray( this->Proxies, this->ProxyCount, dwNewSize ) ||
+				!GrowArray( this->Endpoints, this->ProxyCount*2, dwNewSize*2 ) ||
+				!GrowArray( this->Active, 0, dwNewSize ) ||
+				!GrowArray( this->Remap, 0, dwNewSize ) )
+				return E_OUTOFMEMORY;
+			this->ProxyCapacity = dwNewSize;
+		}
+		dwProxy = this->ProxyCount++;
+		this->KeyProxy[Key] = dwProxy;
+		this->Endpoints[dwProxy*2].Proxy = dwProxy;
+		this->Endpoints[dwProxy*2+1].Proxy = dwProxy | SAP_MAX_END;
+	}
+
+	SAP_PROXY &Proxy = this->Proxies[dwProxy];
+	Proxy.pUser = pUser;
+	Proxy.Key = Key;
+	Proxy.Stamp = this->Stamp;
+	Proxy.Mover = bMover;
+	Proxy.MinX = MinX;
+	Proxy.MaxX = MaxX;
+	Proxy.MinZ = MinZ;
+	Proxy.MaxZ = MaxZ;
+
+	return S_OK;
+}
+int SWEEP_AND_PRUNE::Update()
+{
+	// Drop the proxies that were not set this frame
+	DWORD n = 0;
+	for( DWORD i = 0; i < this->ProxyCount; i++ )
+	{
+		SAP_PROXY &Proxy = this->Proxies[i];
+		if( Proxy.Stamp != this->Stamp )
+		{
+			this->KeyProxy[Proxy.Key] = (DWORD)-1;
+			this->Remap[i] = (DWORD)-1;
+			continue;
+		}
+		if( i != n )
+		{
+			this->Proxies[n] = Proxy;
+			this->KeyProxy[Proxy.Key] = n;
+		}
+		this->Remap[i] = n++;
+	}
+
+	// Remap the endpoints, keeping their order, and refresh their values
+	DWORD dwEnds = 0;
+	for( DWORD i = 0; i < this->ProxyCount*2; i++ )
+	{
+		SAP_ENDPOINT End = this->Endpoints[i];
+		DWORD dwProxy = this->Remap[End.Proxy & ~SAP_MAX_END];
+		if( dwProxy == (DWORD)-1 ) continue;
+
+		End.Proxy = dwProxy | (End.Proxy & SAP_MAX_END);
+		End.Value = (End.Proxy & SAP_MAX_END) ?
+			this->Proxies[dwProxy].MaxX : this->Proxies[dwProxy].MinX;
+		this->Endpoints[dwEnds++] = End;
+	}
+	this->ProxyCount = n;
+	this->Stamp ++;
+
+	/* Insertion sort. Lower ends go before upper ends of equal
+	value, so that boxes which only touch still overlap. */
+	for( DWORD i = 1; i < dwEnds; i++ )
+	{
+		SAP_ENDPOINT End = this->Endpoints[i];
+		DWORD j = i;
+		while( j > 0 &&
+			( this->Endpoints[j-1].Value > End.Value ||
+			( this->Endpoints[j-1].Value == End.Value &&
+			(this->Endpoints[j-1].Proxy & SAP_MAX_END) && !(End.Proxy & SAP_MAX_END) ) ) )
+		{
+			this->Endpoints[j] = this->Endpoints[j-1];
+			j--;
+		}
+		this->Endpoints[j] = End;
+	}
+
+	// Sweep along X, pairing each opening interval with the open ones
+	this->PairCount = 0;
+	DWORD dwActive = 0;
+	for( DWORD i = 0; i < dwEnds; i++ )
+	{
+		DWORD dwProxy = this->Endpoints[i].Proxy & ~SAP_MAX_END;
+		if( this->Endpoints[i].Proxy & SAP_MAX_END )
+		{
+			for( DWORD a = 0; a < dwActive; a++ )
+				if( this->Active[a] == dwProxy ) { this->Active[a] = this->Active[--dwActive]; break; }
+			continue;
+		}
+
+		SAP_PROXY &Proxy = this->Proxies[dwProxy];
+		for( DWORD a = 0; a < dwActive; a++ )
+		{
+			SAP_PROXY &Other = this->Proxies[this->Active[a]];
+			if( Proxy.Mover == Other.Mover ||
+				Proxy.MinZ > Other.MaxZ || Proxy.MaxZ < Other.MinZ )
+				continue;
+
+			if( this->PairCount == this->PairCapacity )
+			{
+				DWORD dwNewSize = this->PairCapacity ? this->PairCapacity*2 : 64;
+				if( !GrowArray( this->Pairs, this->PairCount, dwNewSize ) )
+					return E_OUTOFMEMORY;
+				this->PairCapacity = dwNewSize;
+			}
+			SAP_PAIR &Pair = this->Pairs[this->PairCount++];
+			Pair.Mover = Proxy.Mover ? dwProxy : this->Active[a];
+			Pair.Other = Proxy.Mover ? this->Active[a] : dwProxy;
+		}
+		this->Active[dwActive++] = dwProxy;
+	}
+
+	return S_OK;
+}
+DWORD SWEEP_AND_PRUNE::FindPairs(void * pMover, SAP_PAIR_CALLBACK pfnCallback, void * pContext)
+{
+	// Pairs of one mover, or of all movers if 'pMover' is null
+	DWORD n = 0;
+	for( DWORD i = 0; i < this->PairCount; i++ )
+	{
+		SAP_PAIR &Pair = this->Pairs[i];
+		void * pPairMover = this->Proxies[Pair.Mover].pUser;
+		if( pMover && pPairMover != pMover ) continue;
+
+		pfnCallback( pContext, pPairMover, this->Proxies[Pair.Other].pUser );
+		n++;
+	}
+
+	return n;
+}
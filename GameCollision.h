@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Windows.h>
+
+
+
+/* SweepBoxPoint tests a square box of half-size 'Extents'
+whose centre moves from (X, Z) to (X+MoveX, Z+MoveZ) during
+one step against the point (PointX, PointZ). If the box
+covers the point at any time in the step, it returns true
+and sets 'Toi' to the first such time, from 0 (the start of
+the step) to 1 (the end). */
+bool SweepBoxPoint( float X, float Z, float MoveX, float MoveZ, float Extents,
+	float PointX, float PointZ, float & Toi );
+/* LAWN records which tiles of a level have been cut, one
+bit per tile. The tiles sit on a regular grid that is
+centred on the origin, so the tiles under a box can be
+computed directly from its bounds. Each row of tiles along
+X starts on a fresh word, with tile x in bit x&31 of word
+x>>5, so that Cut can set a whole run of tiles in a row with
+one masked write per word. Cut cuts every tile that a box
+passes over while it moves (see SweepBoxPoint); as the path
+of the box is convex, the tiles it covers in any one row
+form a single run. It returns the number of tiles
+that were not already cut, counted by popcount over the
+words it wrote, which lets the owner keep a running total. */
+struct LAWN
+{
+	void Initialise();
+	void Destroy();
+	int Create(DWORD Width, DWORD Height, float CellSize);
+	DWORD Cut(float X, float Z, float MoveX, float MoveZ, float Extents);
+	DWORD CountCut();
+
+	bool IsCut(DWORD x, DWORD z) { return ((this->Bits[z*this->Pitch + (x>>5)] >> (x&31)) & 1) != 0; }
+	float GetTileX(DWORD x) { return this->OriginX + float(x)*this->CellSize; }
+	float GetTileZ(DWORD z) { return this->OriginZ + float(z)*this->CellSize; }
+
+	DWORD * Bits; // Pitch words per row, row by row along Z
+	DWORD Pitch; // Words per row
+	DWORD Width; // Tiles along X
+	DWORD Height; // Tiles along Z
+	float CellSize;
+	float OriginX; // Centre of tile (0,0)
+	float OriginZ;
+};
+
+
+
+/* SWEEP_AND_PRUNE is a broadphase over axis-aligned boxes
+on the X-Z plane. Each box (proxy) is either a mover or an
+obstacle, and only mover-obstacle pairs are reported.
+Proxies are identified by a small integer key, such as
+the slot of an object's handle, and carry a user pointer.
+Every frame the owner calls SetProxy for each box that
+should take part, then Update: proxies that were not set
+are dropped, the interval endpoints along X are re-sorted
+by insertion sort (cheap, as they barely move between
+frames), and a single sweep collects the pairs whose boxes
+overlap on both axes. FindPairs hands the pairs out. */
+struct SAP_PROXY
+{
+	void * pUser;
+	DWORD Key;
+	DWORD Stamp; // Frame in which the proxy was last set
+	bool Mover;
+	float MinX, MaxX;
+	float MinZ, MaxZ;
+};
+struct SAP_ENDPOINT
+{
+	float Value;
+	DWORD Proxy; // Top bit set for the upper end of the interval
+};
+struct SAP_PAIR
+{
+	DWORD Mover;
+	DWORD Other;
+};
+typedef void (*SAP_PAIR_CALLBACK)(void * pContext, void * pMover, void * pOther);
+
+struct SWEEP_AND_PRUNE
+{
+	void Initialise();
+	void Destroy();
+	int SetProxy(DWORD Key, void * pUser, bool bMover, float MinX, float MaxX, float MinZ, float MaxZ);
+	int Update();
+	DWORD FindPairs(void * pMover, SAP_PAIR_CALLBACK pfnCallback, void * pContext);
+
+	SAP_PROXY * Proxies;
+	DWORD ProxyCount;
+	DWORD ProxyCapacity;
+	DWORD * KeyProxy; // Proxy of each key, or (DWORD)-1
+	DWORD KeyCapacity;
+	SAP_ENDPOINT * Endpoints; // Two per proxy, sorted by value
+	DWORD * Active; // Proxies whose interval is open during the sweep
+	DWORD * Remap; // Scratch for dropping proxies
+	SAP_PAIR * Pairs;
+	DWORD PairCount;
+	DWORD PairCapacity;
+	DWORD Stamp;
+};
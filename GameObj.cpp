@@ -1,250 +1,1083 @@
-
-
-
-#include "GameObj.h"
-#include <new>
-
-
-
-void MOUSE_STATE::Clear()
-{
-	this->Buttons = 0;
-}
-
-
-
-struct QueueBlock
-{
-public:
-	QueueBlock * pNext;
-	DWORD Request[15];
-
-	QueueBlock()
-	{
-		pNext = nullptr;
-		memset( Request, 0, 60 );
-	}
-	~QueueBlock()
-	{
-		if( pNext ) delete pNext;
-	}
-};
-
-Queue::Queue()
-{
-	queue = (void *)new(std::nothrow) QueueBlock();
-}
-Queue::~Queue()
-{
-	if( queue ) delete queue;
-}
-BOOL Queue::AddRequest( int (__stdcall *func)() )
-{
-	QueueBlock *& q = *(QueueBlock **)&queue;
-	if( q )
-	{
-		for( WORD i = 0; i < 15; ++i )
-		{
-			if( !q->Request[i] )
-			{
-				q->Request[i] = (DWORD)func;
-				return TRUE;
-			}
-		}
-		if( !q->pNext )
-		{
-			q->pNext = new(std::nothrow) QueueBlock();
-			if( !q->pNext ) return FALSE;
-			q->Request[0] = (DWORD)func;
-		}
-	}
-
-	return TRUE;
-}
-void Queue::Execute()
-{
-	QueueBlock * pCurrent = (QueueBlock*)this->queue;
-	while( pCurrent )
-	{
-		for( WORD i = 0; i < 15; ++i ) {
-			if( pCurrent->Request[i] ) {
-				( ( int (__stdcall*)() )pCurrent->Request[i] ) ();
-				pCurrent->Request[i] = 0;
-			}
-		} pCurrent = pCurrent->pNext;
-	}
-}
-
-
-
-int GOBJ_PARENT::Create()
-{
-	return S_OK;
-}
-int GOBJ_PARENT::Destroy()
-{
-	delete this;
-
-	return S_OK;
-}
-int GOBJ_PARENT::MsgProc(HWND,UINT,WPARAM,LPARAM)
-{
-	return S_OK;
-}
-
-
-
-int GOBJ_TimeTracker::GetObjId()
-{
-	return GOBJID_TimeTracker;
-}
-int GOBJ_TimeTracker::Initialise()
-{
-	this->Frequency = QueryPerformanceFrequency((LARGE_INTEGER*)&this->Frequency);
-	this->PreviousCount = QueryPerformanceCounter((LARGE_INTEGER*)&this->PreviousCount);
-	this->Elapsed = (UINT64)0;
-	this->DeltaTime = (double)0.0;
-	this->DesirableFPS = (DWORD)60;
-	return S_OK;
-}
-int GOBJ_TimeTracker::Update()
-{
-	UINT64 CurrentCount;
-	QueryPerformanceCounter((LARGE_INTEGER*)&CurrentCount);
-	this->Elapsed = this->PreviousCount - CurrentCount;
-	this->DeltaTime = (double)(
-		( long double(this->Elapsed) / long double(this->Frequency) ) *
-		long double(this->DesirableFPS) );
-	this->PreviousCount = CurrentCount;
-
-	return S_OK;
-}
-
-
-
-int GOBJ_CONTEXT::Initialise()
-{
-	this->ObjectList = 0;
-	this->ListSize = 0;
-
-	return S_OK;
-}
-int GOBJ_CONTEXT::Destroy()
-{
-	if( this->ObjectList )
-	{
-		for( DWORD i = 0; i < this->ListSize; i++ )
-		{
-			if( this->ObjectList[i] )
-				this->ObjectList[i]->Destroy();
-		}
-		delete[] this->ObjectList;
-	}
-
-	GOBJ_PARENT::Destroy();
-
-	return S_OK;
-}
-int GOBJ_CONTEXT::Update()
-{
-	for( DWORD i = 0; i < this->ListSize; i++ ) {
-		if( this->ObjectList[i] )
-			this->ObjectList[i]->Update();
-	} return S_OK;
-}
-int GOBJ_CONTEXT::Render()
-{
-	for( DWORD i = 0; i < this->ListSize; i++ ) {
-		if( this->ObjectList[i] )
-			this->ObjectList[i]->Render();
-	} return S_OK;
-}
-int GOBJ_CONTEXT::Keyboard()
-{
-	for( DWORD i = 0; i < this->ListSize; i++ ) {
-		if( this->ObjectList[i] )
-			this->ObjectList[i]->Keyboard();
-	} return S_OK;
-}
-int GOBJ_CONTEXT::Mouse()
-{
-	for( DWORD i = 0; i < this->ListSize; i++ ) {
-		if( this->ObjectList[i] )
-			this->ObjectList[i]->Mouse();
-	} return S_OK;
-}
-int GOBJ_CONTEXT::RegisterObject(GOBJ_GAME* pObj)
-{
-	// Find empty slot to insert object handle
-	for( DWORD i = 0; i < this->ListSize; i++ )
-	{
-		if( !this->ObjectList[i] ) {
-			this->ObjectList[i] = pObj;
-			return S_OK;
-		} else if( this->ObjectList[i] == pObj )
-			return E_ABORT;
-	}
-	// Expand list
-	DWORD dwNewSize = this->ListSize + 32;
-	GOBJ_GAME** pNewList = new(std::nothrow) GOBJ_GAME *[dwNewSize]();
-	if( !pNewList ) return E_OUTOFMEMORY;
-	if( this->ObjectList )
-	{
-		memcpy( pNewList, this->ObjectList, this->ListSize*sizeof(GOBJ_GAME *) );
-		delete[] this->ObjectList;
-	}
-	this->ObjectList = pNewList;
-	this->ObjectList[this->ListSize] = pObj;
-	this->ListSize = dwNewSize;
-	return S_OK;
-}
-int GOBJ_CONTEXT::UnregisterObject(GOBJ_GAME* pObj)
-{
-	for( DWORD i = 0; i < this->ListSize; i++ )
-	{
-		if( this->ObjectList[i] == pObj ) {
-			this->ObjectList[i] = 0;
-			return S_OK;
-		}
-	}
-	return E_INVALIDARG;
-}
-int GOBJ_CONTEXT::DestroyObject(GOBJ_GAME* pObj)
-{
-	for( DWORD i = 0; i < this->ListSize; i++ )
-	{
-		if( this->ObjectList[i] == pObj ) {
-			this->ObjectList[i]->Destroy();
-			this->ObjectList[i] = 0;
-			return S_OK;
-		}
-	}
-	return E_INVALIDARG;
-}
-int GOBJ_CONTEXT::MsgProc( HWND hWnd, UINT uiMsg, WPARAM wParam, LPARAM lParam )
-{
-	for( DWORD i = 0; i < this->ListSize; i++ )
-	{
-		if( this->ObjectList[i] )
-			this->ObjectList[i]->MsgProc(hWnd,uiMsg,wParam,lParam);
-	}
-	return S_OK;
-}
-
-int GOBJ_GAME::Update()
-{
-	return S_OK;
-}
-int GOBJ_GAME::Render()
-{
-	return S_OK;
-}
-int GOBJ_GAME::Keyboard()
-{
-	return S_OK;
-}
-int GOBJ_GAME::Mouse()
-{
-	return S_OK;
-}
-
+
+
+
+#include "GameObj.h"
+#include <new>
+#include <float.h>
+#include <stdio.h>
+#include <thread>
+
+
+
+template <typename T>
+static bool GrowArray( T *& pArray, DWORD Count, DWORD NewCapacity )
+{
+	T * pNew = new(std::nothrow) T[NewCapacity];
+	if( !pNew ) return false;
+	if( pArray )
+	{
+		memcpy( pNew, pArray, Count*sizeof(T) );
+		delete[] pArray;
+	}
+	pArray = pNew;
+	return true;
+}
+
+
+
+GOBJ_ALLOCATOR * GOBJ_ALLOCATOR::pFirst = nullptr;
+
+GOBJ_ALLOCATOR::GOBJ_ALLOCATOR( const char * szName, size_t BlockSize, DWORD BlocksPerChunk )
+{
+	// Blocks must be able to hold the free list link
+	if( BlockSize < sizeof(void *) ) BlockSize = sizeof(void *);
+
+	this->Name = szName;
+	this->BlockSize = (BlockSize + 15) & ~(size_t)15;
+	this->BlocksPerChunk = BlocksPerChunk ? BlocksPerChunk : 1;
+	this->LiveBlocks = 0;
+	this->HighWater = 0;
+	this->Capacity = 0;
+	this->Allocations = 0;
+	this->Fallbacks = 0;
+	this->pFreeList = nullptr;
+	this->pChunks = nullptr;
+
+	this->pNext = pFirst;
+	pFirst = this;
+}
+GOBJ_ALLOCATOR::~GOBJ_ALLOCATOR()
+{
+	while( this->pChunks )
+	{
+		BYTE * pChunk = (BYTE *)this->pChunks;
+		this->pChunks = *(void **)pChunk;
+		delete[] pChunk;
+	}
+
+	// Unlink from the list of pools
+	for( GOBJ_ALLOCATOR ** pp = &pFirst; *pp; pp = &(*pp)->pNext )
+		if( *pp == this ) { *pp = this->pNext; break; }
+}
+void * GOBJ_ALLOCATOR::Allocate( size_t Size )
+{
+	if( Size > this->BlockSize )
+	{
+		this->Fallbacks ++;
+		return ::operator new( Size, std::nothrow );
+	}
+
+	if( !this->pFreeList )
+	{
+		/* The first 16 bytes of a chunk link it to the next
+		chunk, which keeps the blocks after it aligned. */
+		BYTE * pChunk = new(std::nothrow) BYTE[16 + this->BlockSize*this->BlocksPerChunk];
+		if( !pChunk ) return nullptr;
+		*(void **)pChunk = this->pChunks;
+		this->pChunks = pChunk;
+
+		// Thread the blocks onto the free list in address order
+		BYTE * pBlock = pChunk + 16;
+		for( DWORD i = 0; i < this->BlocksPerChunk; i++, pBlock += this->BlockSize )
+			*(void **)pBlock = i+1 < this->BlocksPerChunk ? pBlock + this->BlockSize : nullptr;
+		this->pFreeList = pChunk + 16;
+		this->Capacity += this->BlocksPerChunk;
+	}
+
+	void * pBlock = this->pFreeList;
+	this->pFreeList = *(void **)pBlock;
+
+	this->Allocations ++;
+	this->LiveBlocks ++;
+	if( this->LiveBlocks > this->HighWater )
+		this->HighWater = this->LiveBlocks;
+
+	return pBlock;
+}
+void GOBJ_ALLOCATOR::Free( void * pBlock, size_t Size )
+{
+	if( !pBlock ) return;
+	if( Size > this->BlockSize )
+	{
+		::operator delete( pBlock );
+		return;
+	}
+
+	*(void **)pBlock = this->pFreeList;
+	this->pFreeList = pBlock;
+	this->LiveBlocks --;
+}
+GOBJ_ALLOCATOR * GOBJ_ALLOCATOR::GetFirst()
+{
+	return pFirst;
+}
+GOBJ_ALLOCATOR * GOBJ_ALLOCATOR::GetNext()
+{
+	return this->pNext;
+}
+void GOBJ_ALLOCATOR::ReportAll()
+{
+	char str[256];
+	for( GOBJ_ALLOCATOR * p = pFirst; p; p = p->pNext )
+	{
+		sprintf_s( str, 256,
+			"Pool %s: %u-byte blocks, %u live, high-water %u, capacity %u, %u allocations, %u heap fallbacks.\n",
+			p->Name, (DWORD)p->BlockSize, p->LiveBlocks, p->HighWater,
+			p->Capacity, p->Allocations, p->Fallbacks );
+		OutputDebugStringA( str );
+	}
+}
+
+
+
+void MOUSE_STATE::Clear()
+{
+	this->Buttons = 0;
+}
+
+
+
+Queue::Queue()
+{
+	for( unsigned int i = 0; i < QUEUE_CAPACITY; ++i )
+		this->Slots[i].Sequence.store( i, std::memory_order_relaxed );
+	this->Tail.store( 0, std::memory_order_relaxed );
+	this->Head = 0;
+}
+Queue::~Queue()
+{
+	// Requests that never ran still own their closures
+	while( this->Slots[this->Head % QUEUE_CAPACITY].Sequence.load( std::memory_order_acquire ) == this->Head+1 )
+	{
+		QUEUE_REQUEST &Slot = this->Slots[this->Head % QUEUE_CAPACITY];
+		Slot.pfnDestroy( Slot.Storage );
+		this->Head ++;
+	}
+}
+QUEUE_REQUEST * Queue::Claim()
+{
+	/* A slot is free for the producer at position 'Pos'
+	once its sequence has come round to 'Pos'; if it still
+	lags behind, the ring is full. */
+	unsigned int Pos = this->Tail.load( std::memory_order_relaxed );
+	while( true )
+	{
+		QUEUE_REQUEST &Slot = this->Slots[Pos % QUEUE_CAPACITY];
+		int Diff = int( Slot.Sequence.load( std::memory_order_acquire ) - Pos );
+		if( Diff == 0 )
+		{
+			if( this->Tail.compare_exchange_weak( Pos, Pos+1, std::memory_order_relaxed ) )
+				return &Slot;
+		}
+		else if( Diff < 0 )
+			return nullptr;
+		else
+			Pos = this->Tail.load( std::memory_order_relaxed );
+	}
+}
+void Queue::Publish( QUEUE_REQUEST * pSlot )
+{
+	unsigned int Pos = pSlot->Sequence.load( std::memory_order_relaxed );
+	pSlot->Sequence.store( Pos+1, std::memory_order_release );
+}
+BOOL Queue::AddRequest( int (__stdcall *func)() )
+{
+	struct CALL
+	{
+		int (__stdcall *func)();
+		void operator () () const { func(); }
+	};
+	CALL Call = { func };
+	return this->Post( Call );
+}
+BOOL Queue::IsPending()
+{
+	return this->Tail.load( std::memory_order_acquire ) != this->Head;
+}
+void Queue::Execute()
+{
+	/* Requests added while these run (including by the
+	requests themselves) wait for the next call. */
+	unsigned int End = this->Tail.load( std::memory_order_acquire );
+	while( this->Head != End )
+	{
+		QUEUE_REQUEST &Slot = this->Slots[this->Head % QUEUE_CAPACITY];
+		if( Slot.Sequence.load( std::memory_order_acquire ) != this->Head+1 )
+			break; // Claimed but not yet published
+
+		Slot.pfnInvoke( Slot.Storage );
+		Slot.pfnDestroy( Slot.Storage );
+		Slot.Sequence.store( this->Head + QUEUE_CAPACITY, std::memory_order_release );
+		this->Head ++;
+	}
+}
+
+#ifdef MOWVE_IT_BENCHMARK
+/* Times 1 to 16 threads posting small closures to one
+queue, which this thread drains, and writes the throughput
+to the debugger output. Producers retry while the ring
+is full, as a loading thread would. */
+struct QUEUE_BENCHMARK_REQUEST
+{
+	unsigned int * pDone; // Only touched by the consumer
+	void operator () () const { (*pDone) ++; }
+};
+void BenchmarkRequestQueue()
+{
+	const unsigned int PerProducer = 100000;
+	for( unsigned int Producers = 1; Producers <= 16; Producers *= 2 )
+	{
+		Queue * pQueue = new(std::nothrow) Queue();
+		if( !pQueue ) return;
+
+		unsigned int Done = 0;
+		QUEUE_BENCHMARK_REQUEST Request = { &Done };
+		std::atomic<bool> Go( false );
+		std::thread Threads[16];
+		for( unsigned int p = 0; p < Producers; p++ )
+		{
+			Threads[p] = std::thread( [pQueue, Request, &Go]()
+			{
+				while( !Go.load( std::memory_order_acquire ) );
+				for( unsigned int i = 0; i < PerProducer; i++ )
+					while( !pQueue->Post( Request ) )
+						std::this_thread::yield();
+			} );
+		}
+
+		UINT64 Frequency, Start, End;
+		QueryPerformanceFrequency( (LARGE_INTEGER *)&Frequency );
+		QueryPerformanceCounter( (LARGE_INTEGER *)&Start );
+		Go.store( true, std::memory_order_release );
+		while( Done < Producers*PerProducer )
+			pQueue->Execute();
+		QueryPerformanceCounter( (LARGE_INTEGER *)&End );
+
+		for( unsigned int p = 0; p < Producers; p++ )
+			Threads[p].join();
+		delete pQueue;
+
+		double fSeconds = double(End - Start) / double(Frequency);
+		char str[256];
+		sprintf_s( str, 256, "Queue %2u producers: %u requests in %.3f ms (%.1f M requests/s).\n",
+			Producers, Done, fSeconds*1000.0, double(Done) / fSeconds * 1e-6 );
+		OutputDebugStringA( str );
+	}
+}
+#endif
+
+
+
+int SCHEDULER::Initialise()
+{
+	this->Heap = nullptr;
+	this->HeapSize = 0;
+	this->HeapCapacity = 0;
+	this->pFree = nullptr;
+	this->Now = 0;
+	this->Sequence = 0;
+
+	return S_OK;
+}
+int SCHEDULER::Destroy()
+{
+	this->Clear();
+	while( this->pFree )
+	{
+		SCHEDULE_ENTRY * pNext = this->pFree->pNextFree;
+		delete this->pFree;
+		this->pFree = pNext;
+	}
+	delete[] this->Heap;
+	this->Heap = nullptr;
+	this->HeapCapacity = 0;
+
+	return S_OK;
+}
+SCHEDULE_ENTRY * SCHEDULER::Allocate()
+{
+	SCHEDULE_ENTRY * pEntry = this->pFree;
+	if( pEntry )
+		this->pFree = pEntry->pNextFree;
+	else
+		pEntry = new(std::nothrow) SCHEDULE_ENTRY;
+
+	return pEntry;
+}
+void SCHEDULER::Release(SCHEDULE_ENTRY * pEntry)
+{
+	pEntry->pfnDestroy( pEntry->Storage );
+	pEntry->pNextFree = this->pFree;
+	this->pFree = pEntry;
+}
+bool SCHEDULER::Before(SCHEDULE_ENTRY * pA, SCHEDULE_ENTRY * pB)
+{
+	// Ticks and sequences are compared so that they may wrap
+	if( pA->Due != pB->Due )
+		return int( pA->Due - pB->Due ) < 0;
+	if( pA->Priority != pB->Priority )
+		return pA->Priority < pB->Priority;
+	return int( pA->Sequence - pB->Sequence ) < 0;
+}
+BOOL SCHEDULER::Push(SCHEDULE_ENTRY * pEntry, DWORD Tick, DWORD Priority)
+{
+	if( this->HeapSize == this->HeapCapacity )
+	{
+		DWORD dwNewSize = this->HeapCapacity ? this->HeapCapacity*2 : 32;
+		if( !GrowArray( this->Heap, this->HeapSize, dwNewSize ) )
+		{
+			this->Release( pEntry );
+			return FALSE;
+		}
+		this->HeapCapacity = dwNewSize;
+	}
+
+	// Nothing runs on a tick that has already been advanced to
+	pEntry->Due = int( Tick - this->Now ) > 0 ? Tick : this->Now + 1;
+	pEntry->Priority = Priority;
+	pEntry->Sequence = this->Sequence ++;
+
+	// Sift up
+	DWORD i = this->HeapSize ++;
+	while( i )
+	{
+		DWORD Parent = (i - 1) / 2;
+		if( !this->Before( pEntry, this->Heap[Parent] ) )
+			break;
+		this->Heap[i] = this->Heap[Parent];
+		i = Parent;
+	}
+	this->Heap[i] = pEntry;
+
+	return TRUE;
+}
+void SCHEDULER::Advance()
+{
+	this->Now ++;
+	while( this->HeapSize && int( this->Heap[0]->Due - this->Now ) <= 0 )
+	{
+		SCHEDULE_ENTRY * pEntry = this->Heap[0];
+
+		// Sift the last entry down from the root
+		SCHEDULE_ENTRY * pLast = this->Heap[--this->HeapSize];
+		DWORD i = 0;
+		while( true )
+		{
+			DWORD Child = i*2 + 1;
+			if( Child >= this->HeapSize )
+				break;
+			if( Child+1 < this->HeapSize && this->Before( this->Heap[Child+1], this->Heap[Child] ) )
+				Child ++;
+			if( !this->Before( this->Heap[Child], pLast ) )
+				break;
+			this->Heap[i] = this->Heap[Child];
+			i = Child;
+		}
+		if( this->HeapSize )
+			this->Heap[i] = pLast;
+
+		// The request may schedule more; they go in behind it
+		pEntry->pfnInvoke( pEntry->Storage );
+		this->Release( pEntry );
+	}
+}
+void SCHEDULER::Clear()
+{
+	for( DWORD i = 0; i < this->HeapSize; i++ )
+		this->Release( this->Heap[i] );
+	this->HeapSize = 0;
+}
+DWORD SCHEDULER::GetTick()
+{
+	return this->Now;
+}
+DWORD SCHEDULER::GetPendingCount()
+{
+	return this->HeapSize;
+}
+
+
+
+int GOBJ_PARENT::Create()
+{
+	return S_OK;
+}
+int GOBJ_PARENT::Destroy()
+{
+	delete this;
+
+	return S_OK;
+}
+int GOBJ_PARENT::MsgProc(HWND,UINT,WPARAM,LPARAM)
+{
+	return S_OK;
+}
+
+
+
+int GOBJ_TimeTracker::GetObjId()
+{
+	return GOBJID_TimeTracker;
+}
+int GOBJ_TimeTracker::Initialise()
+{
+	QueryPerformanceFrequency((LARGE_INTEGER*)&this->Frequency);
+	QueryPerformanceCounter((LARGE_INTEGER*)&this->PreviousCount);
+	this->Elapsed = (UINT64)0;
+	this->Accumulator = (UINT64)0;
+	this->MaxTicks = (DWORD)5;
+	this->Alpha = 0.0f;
+	this->TickRate = (DWORD)GOBJ_TICK_RATE;
+	this->TickLength = this->Frequency / GOBJ_TICK_RATE;
+	if( !this->TickLength ) this->TickLength = 1;
+	return S_OK;
+}
+int GOBJ_TimeTracker::Update()
+{
+	UINT64 CurrentCount;
+	QueryPerformanceCounter((LARGE_INTEGER*)&CurrentCount);
+	this->Elapsed = CurrentCount - this->PreviousCount;
+	this->PreviousCount = CurrentCount;
+
+	/* After a stall (loading a level, a message box or the
+	window being dragged) the lost time is dropped rather
+	than simulated all at once. */
+	this->Accumulator += this->Elapsed;
+	if( this->Accumulator > this->TickLength*this->MaxTicks )
+		this->Accumulator = this->TickLength*this->MaxTicks;
+	this->Alpha = float( (double)this->Accumulator / (double)this->TickLength );
+
+	return S_OK;
+}
+bool GOBJ_TimeTracker::Tick()
+{
+	if( this->Accumulator < this->TickLength )
+		return false;
+
+	this->Accumulator -= this->TickLength;
+	this->Alpha = float( (double)this->Accumulator / (double)this->TickLength );
+	return true;
+}
+
+
+
+int GOBJ_CONTEXT::Initialise()
+{
+	this->ObjectList = 0;
+	this->ListSize = 0;
+	this->ListVirtual = 0;
+	this->ListCapacity = 0;
+	this->ListSlot = 0;
+	this->Slots = 0;
+	this->SlotCount = 0;
+	this->FreeSlot = (DWORD)-1;
+	this->KillList = 0;
+	this->KillCount = 0;
+	this->KillCapacity = 0;
+	for( DWORD i = 0; i < GOBJID_Count; i++ )
+	{
+		this->Components[i].Initialise();
+		this->Kernels[i].Update = nullptr;
+		this->Kernels[i].Render = nullptr;
+		this->Kernels[i].Batched = false;
+		this->FirstOfKind[i] = nullptr;
+		this->CountOfKind[i] = 0;
+	}
+	this->Schedule.Initialise();
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::Destroy()
+{
+	this->Schedule.Destroy();
+	this->DestroyAllObjects();
+	delete[] this->ObjectList;
+	delete[] this->ListSlot;
+	delete[] this->Slots;
+	delete[] this->KillList;
+	for( DWORD i = 0; i < GOBJID_Count; i++ )
+		this->Components[i].Destroy();
+
+	GOBJ_PARENT::Destroy();
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::Update()
+{
+	this->Schedule.Advance();
+
+	// Keep where everything was before this tick, for rendering
+	for( DWORD k = 0; k < GOBJID_Count; k++ )
+		if( this->Components[k].Count )
+			this->Components[k].Snapshot();
+
+	for( DWORD i = 0; i < this->ListVirtual; i++ )
+		this->ObjectList[i]->Update();
+	for( DWORD k = 0; k < GOBJID_Count; k++ )
+		if( this->Kernels[k].Update && this->Components[k].Count )
+			this->Kernels[k].Update( this->Components[k], 0, this->Components[k].Count );
+	return S_OK;
+}
+int GOBJ_CONTEXT::Render()
+{
+	// Batched kinds first, so overlays drawn by objects stay on top
+	for( DWORD k = 0; k < GOBJID_Count; k++ )
+		if( this->Kernels[k].Render && this->Components[k].Count )
+			this->Kernels[k].Render( this->Components[k], 0, this->Components[k].Count );
+	for( DWORD i = 0; i < this->ListVirtual; i++ )
+		this->ObjectList[i]->Render();
+	return S_OK;
+}
+int GOBJ_CONTEXT::Keyboard()
+{
+	for( DWORD i = 0; i < this->ListVirtual; i++ )
+		this->ObjectList[i]->Keyboard();
+	return S_OK;
+}
+int GOBJ_CONTEXT::Mouse()
+{
+	for( DWORD i = 0; i < this->ListVirtual; i++ )
+		this->ObjectList[i]->Mouse();
+	return S_OK;
+}
+int GOBJ_CONTEXT::RegisterObject(GOBJ_GAME* pObj, GOBJ_HANDLE* phOut)
+{
+	// Already registered?
+	if( this->ResolveHandle( pObj->Handle ) == pObj )
+		return E_ABORT;
+
+	// Make room in both the packed list and the slot table
+	if( this->ListSize == this->ListCapacity )
+	{
+		DWORD dwNewSize = this->ListCapacity ? this->ListCapacity*2 : 32;
+		if( !GrowArray( this->ObjectList, this->ListSize, dwNewSize ) ||
+			!GrowArray( this->ListSlot, this->ListSize, dwNewSize ) )
+			return E_OUTOFMEMORY;
+		this->ListCapacity = dwNewSize;
+	}
+	if( this->FreeSlot == (DWORD)-1 )
+	{
+		DWORD dwNewSize = this->SlotCount ? this->SlotCount*2 : 32;
+		if( !GrowArray( this->Slots, this->SlotCount, dwNewSize ) )
+			return E_OUTOFMEMORY;
+
+		// Chain the new slots onto the free list
+		for( DWORD i = this->SlotCount; i < dwNewSize; i++ )
+		{
+			this->Slots[i].Index = i+1 < dwNewSize ? i+1 : (DWORD)-1;
+			this->Slots[i].Generation = 1;
+		}
+		this->FreeSlot = this->SlotCount;
+		this->SlotCount = dwNewSize;
+	}
+
+	// Pooled objects receive a row in the store of their kind
+	if( pObj->IsPooled() )
+	{
+		GOBJ_GAME_POOLED *pPooled = (GOBJ_GAME_POOLED *)pObj;
+		if( pPooled->pStore ) return E_ABORT;
+		if( FAILED( this->Components[pObj->GetObjId()].Insert( pPooled ) ) )
+			return E_OUTOFMEMORY;
+	}
+
+	// Take a slot from the free list
+	DWORD dwSlot = this->FreeSlot;
+	GOBJ_SLOT &Slot = this->Slots[dwSlot];
+	this->FreeSlot = Slot.Index;
+
+	// Objects that are not batched go before the batched ones
+	DWORD i = this->ListSize++;
+	if( !this->IsBatched( pObj ) )
+	{
+		if( this->ListVirtual != i )
+			this->MoveEntry( this->ListVirtual, i );
+		i = this->ListVirtual++;
+	}
+	this->ObjectList[i] = pObj;
+	this->ListSlot[i] = dwSlot;
+	Slot.Index = i;
+
+	pObj->Handle.Index = dwSlot;
+	pObj->Handle.Generation = Slot.Generation;
+	if( phOut ) *phOut = pObj->Handle;
+
+	this->LinkKind( pObj );
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::UnregisterObject(GOBJ_GAME* pObj)
+{
+	if( this->ResolveHandle( pObj->Handle ) != pObj )
+		return E_INVALIDARG;
+	if( pObj->Killed ) return E_ABORT; // Owned by the kill list
+
+	DWORD dwSlot = pObj->Handle.Index;
+	DWORD i = this->Slots[dwSlot].Index;
+
+	/* Move the last object of the same group into the hole,
+	and if that leaves a hole at the end of the objects
+	which are not batched, the last batched object. */
+	if( i < this->ListVirtual )
+	{
+		DWORD last = -- this->ListVirtual;
+		if( i != last ) this->MoveEntry( last, i );
+		i = last;
+	}
+	DWORD last = -- this->ListSize;
+	if( i != last ) this->MoveEntry( last, i );
+
+	this->RetireSlot( dwSlot );
+	this->UnlinkKind( pObj );
+
+	pObj->Handle.Index = 0;
+	pObj->Handle.Generation = 0;
+
+	if( pObj->IsPooled() && ((GOBJ_GAME_POOLED *)pObj)->pStore )
+		((GOBJ_GAME_POOLED *)pObj)->pStore->Remove( (GOBJ_GAME_POOLED *)pObj );
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::ReplaceObject(GOBJ_GAME* pOld, GOBJ_GAME* pNew)
+{
+	/* The new object takes over the slot and list position
+	of the old one, so passes see it in the same order. The
+	slot still gets a new generation, since handles to the
+	old object must not resolve to the new one. */
+	if( this->ResolveHandle( pOld->Handle ) != pOld )
+		return E_INVALIDARG;
+	if( pOld->Killed ) return E_ABORT;
+	if( this->ResolveHandle( pNew->Handle ) == pNew )
+		return E_ABORT;
+	if( this->IsBatched( pOld ) != this->IsBatched( pNew ) )
+		return E_INVALIDARG;
+
+	if( pNew->IsPooled() )
+	{
+		GOBJ_GAME_POOLED *pPooled = (GOBJ_GAME_POOLED *)pNew;
+		if( pPooled->pStore ) return E_ABORT;
+		if( FAILED( this->Components[pNew->GetObjId()].Insert( pPooled ) ) )
+			return E_OUTOFMEMORY;
+	}
+	if( pOld->IsPooled() && ((GOBJ_GAME_POOLED *)pOld)->pStore )
+		((GOBJ_GAME_POOLED *)pOld)->pStore->Remove( (GOBJ_GAME_POOLED *)pOld );
+
+	GOBJ_SLOT &Slot = this->Slots[pOld->Handle.Index];
+	Slot.Generation ++;
+	if( Slot.Generation == 0 )
+		Slot.Generation = 1;
+	this->ObjectList[Slot.Index] = pNew;
+
+	pNew->Handle.Index = pOld->Handle.Index;
+	pNew->Handle.Generation = Slot.Generation;
+	pOld->Handle.Index = 0;
+	pOld->Handle.Generation = 0;
+
+	this->UnlinkKind( pOld );
+	this->LinkKind( pNew );
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::DestroyObject(GOBJ_GAME* pObj)
+{
+	if( FAILED( this->UnregisterObject( pObj ) ) )
+		return E_INVALIDARG;
+	pObj->Destroy();
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::DestroyAllObjects()
+{
+	this->FlushKills();
+
+	// Nothing scheduled for these objects may run in a later level
+	this->Schedule.Clear();
+
+	// Unregistering from the back never moves another object
+	while( this->ListSize )
+		this->DestroyObject( this->ObjectList[this->ListSize-1] );
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::KillObject(GOBJ_GAME* pObj)
+{
+	/* The object stays registered, and keeps being updated
+	and rendered, until the kill list is flushed. */
+	if( this->ResolveHandle( pObj->Handle ) != pObj )
+		return E_INVALIDARG;
+	if( pObj->Killed )
+		return E_ABORT;
+
+	if( this->KillCount == this->KillCapacity )
+	{
+		DWORD dwNewSize = this->KillCapacity ? this->KillCapacity*2 : 16;
+		if( !GrowArray( this->KillList, this->KillCount, dwNewSize ) )
+			return E_OUTOFMEMORY;
+		this->KillCapacity = dwNewSize;
+	}
+	this->KillList[this->KillCount++] = pObj;
+	pObj->Killed = true;
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::ExpireObject(GOBJ_GAME* pObj, DWORD Ticks)
+{
+	if( this->ResolveHandle( pObj->Handle ) != pObj )
+		return E_INVALIDARG;
+
+	struct EXPIRE
+	{
+		GOBJ_CONTEXT * pContext;
+		GOBJ_HANDLE hObj;
+		void operator () () const
+		{
+			GOBJ_GAME * pObj = pContext->ResolveHandle( hObj );
+			if( pObj && !pObj->Killed )
+				pContext->KillObject( pObj );
+		}
+	};
+	EXPIRE Expire = { this, pObj->Handle };
+	if( !this->Schedule.RunAt( this->Schedule.GetTick() + Ticks, Expire ) )
+		return E_OUTOFMEMORY;
+
+	return S_OK;
+}
+int GOBJ_CONTEXT::FlushKills()
+{
+	if( !this->KillCount )
+		return S_OK;
+
+	// Retire the slots and leave a hole behind each object
+	for( DWORD k = 0; k < this->KillCount; k++ )
+	{
+		GOBJ_GAME *pObj = this->KillList[k];
+		DWORD dwSlot = pObj->Handle.Index;
+
+		this->ObjectList[this->Slots[dwSlot].Index] = nullptr;
+		this->RetireSlot( dwSlot );
+		this->UnlinkKind( pObj );
+
+		pObj->Handle.Index = 0;
+		pObj->Handle.Generation = 0;
+
+		if( pObj->IsPooled() && ((GOBJ_GAME_POOLED *)pObj)->pStore )
+			((GOBJ_GAME_POOLED *)pObj)->pStore->Remove( (GOBJ_GAME_POOLED *)pObj );
+	}
+
+	// Close all holes in one pass, keeping the survivors in order
+	DWORD j = 0, dwVirtual = 0;
+	for( DWORD i = 0; i < this->ListSize; i++ )
+	{
+		if( !this->ObjectList[i] ) continue;
+		if( i < this->ListVirtual ) dwVirtual ++;
+		if( i != j ) this->MoveEntry( i, j );
+		j++;
+	}
+	this->ListSize = j;
+	this->ListVirtual = dwVirtual;
+
+	// Release the objects as one batch
+	for( DWORD k = 0; k < this->KillCount; k++ )
+		this->KillList[k]->Destroy();
+	this->KillCount = 0;
+
+	return S_OK;
+}
+GOBJ_GAME * GOBJ_CONTEXT::ResolveHandle(GOBJ_HANDLE hObj)
+{
+	if( hObj.Generation == 0 ||
+		hObj.Index >= this->SlotCount ||
+		this->Slots[hObj.Index].Generation != hObj.Generation )
+		return nullptr;
+
+	return this->ObjectList[this->Slots[hObj.Index].Index];
+}
+bool GOBJ_CONTEXT::IsAlive(GOBJ_HANDLE hObj)
+{
+	return this->ResolveHandle( hObj ) != nullptr;
+}
+GOBJ_GAME * GOBJ_CONTEXT::GetFirstObject(DWORD ObjId)
+{
+	return ObjId < GOBJID_Count ? this->FirstOfKind[ObjId] : nullptr;
+}
+DWORD GOBJ_CONTEXT::GetObjectCount(DWORD ObjId)
+{
+	return ObjId < GOBJID_Count ? this->CountOfKind[ObjId] : 0;
+}
+int GOBJ_CONTEXT::SetKernels(DWORD ObjId, GOBJ_KERNEL Update, GOBJ_KERNEL Render)
+{
+	/* Objects already registered were placed according to
+	the old setting, so a kind can only be switched while
+	none of its objects exist. */
+	if( ObjId >= GOBJID_Count )
+		return E_INVALIDARG;
+	if( this->Components[ObjId].Count )
+		return E_ABORT;
+
+	this->Kernels[ObjId].Update = Update;
+	this->Kernels[ObjId].Render = Render;
+	this->Kernels[ObjId].Batched = Update || Render;
+
+	return S_OK;
+}
+bool GOBJ_CONTEXT::IsBatched(GOBJ_GAME* pObj)
+{
+	return pObj->IsPooled() && this->Kernels[pObj->GetObjId()].Batched;
+}
+void GOBJ_CONTEXT::RetireSlot(DWORD dwSlot)
+{
+	// Outstanding handles to the slot become stale
+	GOBJ_SLOT &Slot = this->Slots[dwSlot];
+	Slot.Generation ++;
+	if( Slot.Generation == 0 )
+		Slot.Generation = 1;
+	Slot.Index = this->FreeSlot;
+	this->FreeSlot = dwSlot;
+}
+void GOBJ_CONTEXT::MoveEntry(DWORD From, DWORD To)
+{
+	this->ObjectList[To] = this->ObjectList[From];
+	this->ListSlot[To] = this->ListSlot[From];
+	this->Slots[this->ListSlot[To]].Index = To;
+}
+void GOBJ_CONTEXT::LinkKind(GOBJ_GAME* pObj)
+{
+	DWORD Kind = pObj->GetObjId();
+	if( Kind >= GOBJID_Count ) Kind = GOBJID_Null;
+
+	pObj->Kind = Kind;
+	pObj->pPrevOfKind = nullptr;
+	pObj->pNextOfKind = this->FirstOfKind[Kind];
+	if( pObj->pNextOfKind )
+		pObj->pNextOfKind->pPrevOfKind = pObj;
+	this->FirstOfKind[Kind] = pObj;
+	this->CountOfKind[Kind] ++;
+}
+void GOBJ_CONTEXT::UnlinkKind(GOBJ_GAME* pObj)
+{
+	if( pObj->pPrevOfKind )
+		pObj->pPrevOfKind->pNextOfKind = pObj->pNextOfKind;
+	else
+		this->FirstOfKind[pObj->Kind] = pObj->pNextOfKind;
+	if( pObj->pNextOfKind )
+		pObj->pNextOfKind->pPrevOfKind = pObj->pPrevOfKind;
+	this->CountOfKind[pObj->Kind] --;
+
+	pObj->pPrevOfKind = nullptr;
+	pObj->pNextOfKind = nullptr;
+}
+int GOBJ_CONTEXT::MsgProc( HWND hWnd, UINT uiMsg, WPARAM wParam, LPARAM lParam )
+{
+	for( DWORD i = 0; i < this->ListVirtual; i++ )
+		this->ObjectList[i]->MsgProc(hWnd,uiMsg,wParam,lParam);
+	return S_OK;
+}
+
+GOBJ_GAME::GOBJ_GAME()
+{
+	this->Handle.Index = 0;
+	this->Handle.Generation = 0;
+	this->Killed = false;
+	this->Kind = GOBJID_Null;
+	this->pPrevOfKind = nullptr;
+	this->pNextOfKind = nullptr;
+}
+int GOBJ_GAME::Update()
+{
+	return S_OK;
+}
+int GOBJ_GAME::Render()
+{
+	return S_OK;
+}
+int GOBJ_GAME::Keyboard()
+{
+	return S_OK;
+}
+int GOBJ_GAME::Mouse()
+{
+	return S_OK;
+}
+bool GOBJ_GAME::IsPooled()
+{
+	return false;
+}
+
+
+
+GOBJ_GAME_POOLED::GOBJ_GAME_POOLED()
+{
+	this->pStore = nullptr;
+	this->Slot = 0;
+}
+int GOBJ_GAME_POOLED::Destroy()
+{
+	// Give the row (and its mesh reference) back to the store
+	if( this->pStore )
+		this->pStore->Remove( this );
+
+	GOBJ_GAME::Destroy();
+
+	return S_OK;
+}
+bool GOBJ_GAME_POOLED::IsPooled()
+{
+	return true;
+}
+
+
+
+int GOBJ_COMPONENTS::Initialise()
+{
+	this->Count = 0;
+	this->Capacity = 0;
+	this->Owner = nullptr;
+	this->Mesh = nullptr;
+	this->PosX = nullptr;
+	this->PosY = nullptr;
+	this->PosZ = nullptr;
+	this->PrevX = nullptr;
+	this->PrevY = nullptr;
+	this->PrevZ = nullptr;
+	this->VelX = nullptr;
+	this->VelY = nullptr;
+	this->VelZ = nullptr;
+	this->Scale = nullptr;
+	this->FrameCount = nullptr;
+	this->Flag = nullptr;
+
+	return S_OK;
+}
+int GOBJ_COMPONENTS::Destroy()
+{
+	// Any rows still present belong to objects being torn down
+	while( this->Count )
+		this->Remove( this->Owner[this->Count-1] );
+
+	delete[] this->Owner;
+	delete[] this->Mesh;
+	delete[] this->PosX;
+	delete[] this->PosY;
+	delete[] this->PosZ;
+	delete[] this->PrevX;
+	delete[] this->PrevY;
+	delete[] this->PrevZ;
+	delete[] this->VelX;
+	delete[] this->VelY;
+	delete[] this->VelZ;
+	delete[] this->Scale;
+	delete[] this->FrameCount;
+	delete[] this->Flag;
+
+	return this->Initialise();
+}
+int GOBJ_COMPONENTS::Reserve(DWORD NewCapacity)
+{
+	if( NewCapacity <= this->Capacity ) return S_OK;
+
+	/* Arrays which have already grown are left larger
+	if a later one fails, which is harmless. */
+	if( !GrowArray( this->Owner, this->Count, NewCapacity ) ||
+		!GrowArray( this->Mesh, this->Count, NewCapacity ) ||
+		!GrowArray( this->PosX, this->Count, NewCapacity ) ||
+		!GrowArray( this->PosY, this->Count, NewCapacity ) ||
+		!GrowArray( this->PosZ, this->Count, NewCapacity ) ||
+		!GrowArray( this->PrevX, this->Count, NewCapacity ) ||
+		!GrowArray( this->PrevY, this->Count, NewCapacity ) ||
+		!GrowArray( this->PrevZ, this->Count, NewCapacity ) ||
+		!GrowArray( this->VelX, this->Count, NewCapacity ) ||
+		!GrowArray( this->VelY, this->Count, NewCapacity ) ||
+		!GrowArray( this->VelZ, this->Count, NewCapacity ) ||
+		!GrowArray( this->Scale, this->Count, NewCapacity ) ||
+		!GrowArray( this->FrameCount, this->Count, NewCapacity ) ||
+		!GrowArray( this->Flag, this->Count, NewCapacity ) )
+	{
+		return E_OUTOFMEMORY;
+	}
+	this->Capacity = NewCapacity;
+
+	return S_OK;
+}
+int GOBJ_COMPONENTS::Insert(GOBJ_GAME_POOLED* pObj)
+{
+	if( this->Count == this->Capacity )
+	{
+		if( FAILED( this->Reserve( this->Capacity ? this->Capacity*2 : 32 ) ) )
+			return E_OUTOFMEMORY;
+	}
+
+	DWORD s = this->Count ++;
+	this->Owner[s] = pObj;
+	this->Mesh[s] = nullptr;
+	this->PosX[s] = 0.0f;
+	this->PosY[s] = 0.0f;
+	this->PosZ[s] = 0.0f;
+	this->PrevX[s] = FLT_MAX;
+	this->PrevY[s] = 0.0f;
+	this->PrevZ[s] = 0.0f;
+	this->VelX[s] = 0.0f;
+	this->VelY[s] = 0.0f;
+	this->VelZ[s] = 0.0f;
+	this->Scale[s] = 1.0f;
+	this->FrameCount[s] = 0;
+	this->Flag[s] = false;
+
+	pObj->pStore = this;
+	pObj->Slot = s;
+
+	return S_OK;
+}
+int GOBJ_COMPONENTS::Remove(GOBJ_GAME_POOLED* pObj)
+{
+	if( pObj->pStore != this ) return E_INVALIDARG;
+
+	DWORD s = pObj->Slot;
+	DWORD last = -- this->Count;
+	if( this->Mesh[s] )
+		this->Mesh[s]->Release();
+
+	// Move last row into the hole
+	if( s != last )
+	{
+		this->Owner[s] = this->Owner[last];
+		this->Mesh[s] = this->Mesh[last];
+		this->PosX[s] = this->PosX[last];
+		this->PosY[s] = this->PosY[last];
+		this->PosZ[s] = this->PosZ[last];
+		this->PrevX[s] = this->PrevX[last];
+		this->PrevY[s] = this->PrevY[last];
+		this->PrevZ[s] = this->PrevZ[last];
+		this->VelX[s] = this->VelX[last];
+		this->VelY[s] = this->VelY[last];
+		this->VelZ[s] = this->VelZ[last];
+		this->Scale[s] = this->Scale[last];
+		this->FrameCount[s] = this->FrameCount[last];
+		this->Flag[s] = this->Flag[last];
+		this->Owner[s]->Slot = s;
+	}
+
+	pObj->pStore = nullptr;
+	pObj->Slot = 0;
+
+	return S_OK;
+}
+void GOBJ_COMPONENTS::Snapshot()
+{
+	memcpy( this->PrevX, this->PosX, this->Count*sizeof(float) );
+	memcpy( this->PrevY, this->PosY, this->Count*sizeof(float) );
+	memcpy( this->PrevZ, this->PosZ, this->Count*sizeof(float) );
+}
+void GOBJ_COMPONENTS::GetRenderPosition(DWORD Row, float Alpha, float * pOut)
+{
+	// Rows added during this tick have nowhere to blend from
+	if( this->PrevX[Row] == FLT_MAX )
+	{
+		pOut[0] = this->PosX[Row];
+		pOut[1] = this->PosY[Row];
+		pOut[2] = this->PosZ[Row];
+		return;
+	}
+	pOut[0] = this->PrevX[Row] + (this->PosX[Row] - this->PrevX[Row])*Alpha;
+	pOut[1] = this->PrevY[Row] + (this->PosY[Row] - this->PrevY[Row])*Alpha;
+	pOut[2] = this->PrevZ[Row] + (this->PosZ[Row] - this->PrevZ[Row])*Alpha;
+}
+
@@ -1,576 +1,1041 @@
-
-#pragma once
-
-#include "GameResource.h"
-#include "CStruct.h"
-
-
-
-/* Basic structures */
-struct PIXEL {
-	union {
-		struct {
-			BYTE r;
-			BYTE g;
-			BYTE b;
-			BYTE a;
-		};
-		DWORD rgba;
-	};
-};
-struct VERTEX
-{
-#define D3DFVF_VERTEX (D3DFVF_TEX1|D3DFVF_NORMAL|D3DFVF_XYZ)
-	float Position[3];
-	float Normal[3];
-	float TexCoord[2];
-};
-struct WaveFileHeader
-{
-	char id[4]; // Should be 'RIFF'
-	DWORD dwFileSize;
-	char header[4]; // Should be 'WAVE'
-	char assert[4]; // Should be "fmt "
-	DWORD dwLenFmtData; // Should be 16
-	WORD wFmtType;
-	WORD dwNumChannels;
-	DWORD dwSampleRate;
-	DWORD dwAvgBytesPerSec;
-	WORD wBlockAlign;
-	WORD dwBitsPerSample;
-};
-struct WaveDataChunk
-{
-	char ChunkName[4];
-	DWORD dwSizeOfChunk;
-};
-
-
-
-/* State structures */
-struct MOUSE_STATE
-{
-	DWORD Buttons;
-	POINT Position;
-	POINT PrevPos;
-
-	void Clear();
-};
-struct KEYBOARD_STATE
-{
-	BYTE Keys[256];
-};
-
-
-
-/* Queue class.
-This structure handles requests that are queued. */
-class Queue
-{
-private:
-	void * queue;
-
-public:
-	Queue();
-	~Queue();
-
-	BOOL AddRequest( int (__stdcall *func)() );
-	void Execute();
-};
-
-
-
-/* This is an enumeration of object IDs. */
-enum GOBJID
-{
-	GOBJID_Null,
-	// Time tracker
-	GOBJID_TimeTracker,
-	// Game contexts
-	GOBJID_CONTEXT_MainMenu,
-	GOBJID_CONTEXT_PauseMenu,
-	GOBJID_CONTEXT_HelpScreen,
-	GOBJID_CONTEXT_OptionsMenu,
-	GOBJID_CONTEXT_MainGame,
-	// User interface objects
-	GOBJID_GAME_UI_StartGame,
-	GOBJID_GAME_UI_HowToPlay,
-	GOBJID_GAME_UI_Options,
-	GOBJID_GAME_UI_Exit,
-	// Mowers
-	GOBJID_GAME_MowerMonster,
-	GOBJID_GAME_MowerMover,
-	GOBJID_GAME_MowerMini,
-	// Others
-	GOBJID_GAME_GrassTile,
-	GOBJID_GAME_Gnome,
-	GOBJID_GAME_StoneOrnament,
-	GOBJID_GAME_Tree,
-	GOBJID_GAME_TreeBeehive,
-	GOBJID_GAME_Cat,
-	GOBJID_GAME_Dog,
-	GOBJID_GAME_RabbitHelper,
-	GOBJID_GAME_MoleHill,
-};
-
-
-
-/* The following are declarations of structures. Eventually
-they will represent the structure of blocks of memory allocated
-in the RAM (Random Access Memory). The first structure is an
-abstract structure, which serves as a base structure from which
-other structures derive from, known as a 'parent-child'
-relationship.
-All derivative structures will contain four basic methods:
-- GetObjId() (returns to the calling thread the ID of the object
-as defined in the enumeration above)
-- Initialise() (Initialises all members of the structure to zero)
-- Create() (this method initialises the structure for use later)
-- Destroy() (this method prepares the structure for deletion and
-then deletes the structure from memory) */
-struct GOBJ_PARENT
-{
-	/* Base structure */
-	virtual int GetObjId()		= 0;
-	virtual int Initialise()	= 0;
-	virtual int Create();
-	virtual int Destroy();
-	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);	
-};
-
-
-
-/* Time tracker object. Used for high resolution time tracking. */
-struct GOBJ_TimeTracker : GOBJ_PARENT
-{
-	int GetObjId();
-	int Initialise();
-	int Update();
-
-	UINT64 Frequency;
-	UINT64 PreviousCount;
-	UINT64 Elapsed;
-	double DeltaTime;
-	DWORD DesirableFPS;
-};
-
-
-
-/* GOBJ_GAME is an abstract structure which
-game objects derive from. */
-struct GOBJ_GAME : GOBJ_PARENT
-{
-	virtual int Update();
-	virtual int Render();
-	virtual int Keyboard();
-	virtual int Mouse();
-};
-
-
-
-/* GOBJ_CONTEXT is an abstract structure which
-game contexts derive from. Game contexts handle
-what happens in a game. */
-struct GOBJ_CONTEXT : GOBJ_PARENT
-{
-	virtual int Initialise();
-	virtual int Destroy();
-	virtual int Update();
-	virtual int Render();
-	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	virtual int Keyboard();
-	virtual int Mouse();
-	int RegisterObject(GOBJ_GAME*);
-	int UnregisterObject(GOBJ_GAME*);
-	int DestroyObject(GOBJ_GAME*);
-
-	GOBJ_GAME** ObjectList;
-	DWORD		ListSize;
-};
-/* GOBJ_CONTEXT_MainMenu is a structure which handles
-what goes on when the Main Menu screen is active. */
-struct GOBJ_CONTEXT_MainMenu : GOBJ_CONTEXT
-{
-	int GetObjId();
-	int Create();
-
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-/* GOBJ_CONTEXT_HelpScreen is a structure which handles
-what goes on when the help screen is active. */
-struct GOBJ_CONTEXT_HelpScreen : GOBJ_CONTEXT
-{
-	int GetObjId();
-	int Initialise();
-
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-
-	WORD page;
-};
-/* GOBJ_CONTEXT_OptionsMenu is a structure which handles
-what goes on when the options screen is active. */
-struct GOBJ_CONTEXT_OptionsMenu : GOBJ_CONTEXT
-{
-	int GetObjId();
-	int Create();
-
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-/* GOBJ_CONTEXT_PauseMenu is a structure which handles
-what goes on when the game becomes paused and a menu
-appears. */
-struct GOBJ_CONTEXT_PauseMenu : GOBJ_CONTEXT
-{
-	int GetObjId();
-	int Destroy();
-
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-
-	GOBJ_CONTEXT * pPrevious;
-};
-/* GOBJ_CONTEXT_MainGame is a structure which handles
-what goes on when the 'New Game' button is selected. */
-struct GOBJ_CONTEXT_MainGame : GOBJ_CONTEXT
-{
-	int GetObjId();
-	int Create();
-
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Update();
-	int Render();
-
-	void Congratulations();
-	void TimeoutGameover();
-	void NoLivesGameover();
-
-	int (__stdcall *OnLevelCompletion)();
-	long score;
-	DWORD TileWidth; // Width extent of tiles from centre
-	DWORD TileHeight; // Height extent of tiles from centre
-	float fGrassCut;
-	DWORD dwTimer; // Frames left before timeout
-	DWORD dwLives; // Lives left
-	D3DXVECTOR3 vecFarView; // Level-specific view position
-};
-
-
-
-/* GOBJ_BUTTON is a base structure from which button
-objects will inherit. */
-struct GOBJ_BUTTON : GOBJ_GAME
-{
-	virtual int Initialise();
-	virtual int Create();
-	virtual int Update();
-	virtual int Render();
-
-	RECT Position;
-	IDirect3DTexture9 *pFace;
-	bool IsAvailable;
-};
-/* GOBJ_BUTTON_StartGame is the structure which
-will become the Start Game button in the main menu. */
-struct GOBJ_BUTTON_StartGame : GOBJ_BUTTON
-{
-	int GetObjId();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-/* GOBJ_BUTTON_Options is the structure which
-will become the Options button in the main menu. */
-struct GOBJ_BUTTON_Options : GOBJ_BUTTON
-{
-	int GetObjId();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-/* GOBJ_BUTTON_Exit is the structure which
-will become the Exit button in the main menu. */
-struct GOBJ_BUTTON_Exit : GOBJ_BUTTON
-{
-	int GetObjId();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-/* GOBJ_BUTTON_Help is the structure which
-will become the help button in the main menu. */
-struct GOBJ_BUTTON_Help : GOBJ_BUTTON
-{
-	int GetObjId();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	int Render();
-};
-
-
-
-/* GOBJ_SLIDER is a base structure from which slider
-user interface objects will derive. */
-struct GOBJ_SLIDER : GOBJ_GAME
-{
-	virtual int Initialise();
-	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);
-	virtual int Update();
-	virtual int Render();
-
-	virtual int OnDrag();
-	virtual int OnRelease();
-
-	DWORD BackColour;
-	DWORD FrontColour;
-	RECT Position;
-	float fSetting;
-	bool IsDragged;
-};
-/* GOBJ_SLIDER_MusicVolume is the structure which
-will become the music volume adjuster. */
-struct GOBJ_SLIDER_MusicVolume : GOBJ_SLIDER
-{
-	int GetObjId();
-	int Create();
-
-	int OnDrag();
-};
-/* GOBJ_SLIDER_GrassDensity is the structure which
-will become the grass density adjuster. */
-struct GOBJ_SLIDER_GrassDensity : GOBJ_SLIDER
-{
-	int GetObjId();
-	int Create();
-
-	int OnDrag();
-	int OnRelease();
-};
-
-
-
-/* GOBJ_FloatingText is the structure which
-will become text which makes an appearance
-on screen before shortly disappearing. */
-struct GOBJ_FloatingText : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	ID3DXFont *pFont;
-	CString TextString;
-	DWORD dwColour;
-	DWORD dwInitFrameCount;
-	DWORD dwFrameCount;
-	DWORD dwAnimStage;
-	float Position[3];
-	float Velocity[3];
-};
-
-
-
-/* GOBJ_GAME_GrassTile is the structure which
-will represent a single tile of grass. */
-struct GOBJ_GAME_GrassTile : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	float Position[3];
-	bool IsMowed;
-};
-
-
-
-/* GOBJ_GAME_MOWER is a base structure from
-which mowers will derive. */
-struct GOBJ_GAME_MOWER : GOBJ_GAME
-{
-	virtual int Initialise();
-	virtual int Destroy();
-	virtual int Update();
-	virtual int Render();
-
-	virtual float GetAxialExtents() = 0; // 'Axial Extent' = extent from center x 2
-	virtual float GetAxialAcceleration() = 0;
-
-	Resource_Mesh * pMesh;
-	float Position[3];
-	float Velocity[3];
-	float Facing[3];
-};
-/* GOBJ_GAME_MowerMini is the structure which
-will represent the Mini Mower. */
-struct GOBJ_GAME_MowerMini : GOBJ_GAME_MOWER
-{
-	int GetObjId();
-	int Create();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-
-	float GetAxialExtents();
-	float GetAxialAcceleration();
-};
-/* GOBJ_GAME_MowerMover is the structure which
-will represent the Mover mower. */
-struct GOBJ_GAME_MowerMover : GOBJ_GAME_MOWER
-{
-	int GetObjId();
-	int Create();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-
-	float GetAxialExtents();
-	float GetAxialAcceleration();
-};
-/* GOBJ_GAME_MowerMonster is the structure which
-will represent the Monster mower. */
-struct GOBJ_GAME_MowerMonster : GOBJ_GAME_MOWER
-{
-	int GetObjId();
-	int Create();
-	int MsgProc(HWND,UINT,WPARAM,LPARAM);
-
-	float GetAxialExtents();
-	float GetAxialAcceleration();
-};
-
-
-
-/* GOBJ_GAME_Gnome is the structure which
-will represent a gnome. */
-struct GOBJ_GAME_Gnome : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float Velocity[3];
-	bool IsSmashed;
-};
-/* GOBJ_GAME_StoneOrnament is the structure which
-will represent a stone ornament. */
-struct GOBJ_GAME_StoneOrnament : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float Velocity[3];
-	bool IsSmashed;
-};
-/* GOBJ_GAME_Tree is the structure which
-will represent a tree obstacle. */
-struct GOBJ_GAME_Tree : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-};
-/* GOBJ_GAME_TreeBeehive is the structure which
-will represent a tree obstacle. */
-struct GOBJ_GAME_TreeBeehive : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	bool IsDisturbed;
-};
-/* GOBJ_GAME_Cat is the structure which
-will represent an obstacle. */
-struct GOBJ_GAME_Cat : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float Velocity[3];
-	bool IsDisturbed;
-};
-/* GOBJ_GAME_Dog is the structure which
-will represent an obstacle. */
-struct GOBJ_GAME_Dog : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float Velocity[3];
-	bool IsDisturbed;
-};
-/* GOBJ_GAME_RabbitHelper is the structure which
-will represent a rabbit. */
-struct GOBJ_GAME_RabbitHelper : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float Velocity[3];
-	float Facing[3];
-};
-/* GOBJ_GAME_MoleHill is the structure which
-will represent a molehill. */
-struct GOBJ_GAME_MoleHill : GOBJ_GAME
-{
-	int GetObjId();
-	int Initialise();
-	int Create();
-	int Destroy();
-	int Update();
-	int Render();
-
-	Resource_Mesh * pMesh;
-	DWORD FrameCount;
-	float Position[3];
-	float SquashScale;
-};
-
+
+#pragma once
+
+#include "GameResource.h"
+#include "CStruct.h"
+#include "GameCollision.h"
+#include <atomic>
+
+
+
+/* Basic structures */
+struct PIXEL {
+	union {
+		struct {
+			BYTE r;
+			BYTE g;
+			BYTE b;
+			BYTE a;
+		};
+		DWORD rgba;
+	};
+};
+struct VERTEX
+{
+#define D3DFVF_VERTEX (D3DFVF_TEX1|D3DFVF_NORMAL|D3DFVF_XYZ)
+	float Position[3];
+	float Normal[3];
+	float TexCoord[2];
+};
+struct WaveFileHeader
+{
+	char id[4]; // Should be 'RIFF'
+	DWORD dwFileSize;
+	char header[4]; // Should be 'WAVE'
+	char assert[4]; // Should be "fmt "
+	DWORD dwLenFmtData; // Should be 16
+	WORD wFmtType;
+	WORD dwNumChannels;
+	DWORD dwSampleRate;
+	DWORD dwAvgBytesPerSec;
+	WORD wBlockAlign;
+	WORD dwBitsPerSample;
+};
+struct WaveDataChunk
+{
+	char ChunkName[4];
+	DWORD dwSizeOfChunk;
+};
+
+
+
+/* State structures */
+struct MOUSE_STATE
+{
+	DWORD Buttons;
+	POINT Position;
+	POINT PrevPos;
+
+	void Clear();
+};
+struct KEYBOARD_STATE
+{
+	BYTE Keys[256];
+};
+
+
+
+/* Queue class.
+This structure handles requests that are queued. Requests are
+run by Execute on the main thread, in the order they were
+added, and may be added from any thread: the queue is a
+bounded ring of QUEUE_CAPACITY slots shared by many producers
+and one consumer, without locks. Each slot carries a
+sequence number; a producer claims the slot at the tail by
+advancing the tail with compare-and-swap, stores its request
+and then publishes it by advancing the slot's sequence, which
+Execute waits on. A request is a function pointer or any
+small callable object (a closure), such as a lambda which
+carries its arguments; closures of up to QUEUE_CLOSURE_SIZE
+bytes are stored in the slot itself and larger ones on the
+heap. Adding fails when the ring is full. */
+#define QUEUE_CAPACITY 256 // Must be a power of two
+#define QUEUE_CLOSURE_SIZE 48
+struct QUEUE_REQUEST
+{
+	std::atomic<unsigned int> Sequence;
+	void (*pfnInvoke)(void *);
+	void (*pfnDestroy)(void *);
+	union
+	{
+		unsigned char Storage[QUEUE_CLOSURE_SIZE];
+		double AlignDouble;
+		void * AlignPointer;
+	};
+};
+template <typename T>
+struct QUEUE_CLOSURE
+{
+	static void Invoke( void * p ) { (*(T *)p)(); }
+	static void Destroy( void * p ) { ((T *)p)->~T(); }
+	static void InvokeHeap( void * p ) { (**(T **)p)(); }
+	static void DestroyHeap( void * p ) { delete *(T **)p; }
+};
+class Queue
+{
+private:
+	QUEUE_REQUEST * Claim();
+	void Publish( QUEUE_REQUEST * );
+
+	QUEUE_REQUEST Slots[QUEUE_CAPACITY];
+	std::atomic<unsigned int> Tail; // Next slot for producers
+	unsigned int Head; // Next slot for Execute
+
+public:
+	Queue();
+	~Queue();
+
+	BOOL AddRequest( int (__stdcall *func)() );
+	template <typename T> BOOL Post( const T & Closure );
+	BOOL IsPending();
+	void Execute();
+};
+template <typename T>
+BOOL Queue::Post( const T & Closure )
+{
+	bool bInline = sizeof(T) <= QUEUE_CLOSURE_SIZE && __alignof(T) <= __alignof(double);
+
+	// Copy a large closure before claiming, so a claimed slot never has to be abandoned
+	T * pHeap = nullptr;
+	if( !bInline )
+	{
+		pHeap = new(std::nothrow) T( Closure );
+		if( !pHeap ) return FALSE;
+	}
+
+	QUEUE_REQUEST * pSlot = this->Claim();
+	if( !pSlot )
+	{
+		delete pHeap;
+		return FALSE;
+	}
+
+	if( bInline )
+	{
+		new(pSlot->Storage) T( Closure );
+		pSlot->pfnInvoke = QUEUE_CLOSURE<T>::Invoke;
+		pSlot->pfnDestroy = QUEUE_CLOSURE<T>::Destroy;
+	}
+	else
+	{
+		*(T **)pSlot->Storage = pHeap;
+		pSlot->pfnInvoke = QUEUE_CLOSURE<T>::InvokeHeap;
+		pSlot->pfnDestroy = QUEUE_CLOSURE<T>::DestroyHeap;
+	}
+	this->Publish( pSlot );
+
+	return TRUE;
+}
+
+#ifdef MOWVE_IT_BENCHMARK
+void BenchmarkRequestQueue();
+#endif
+
+
+
+/* The game is simulated in fixed ticks, GOBJ_TICK_RATE to
+the second. The rate cannot be changed while running: every
+gameplay constant (speeds, friction, gravity, timers and
+frame counts) is an amount per tick, tuned for this rate. */
+#define GOBJ_TICK_RATE 60
+
+
+
+/* SCHEDULER holds requests that are to run later: at a
+given tick, or once a given number of milliseconds have been
+simulated. It is driven by Advance, which moves it on by one
+tick and runs what has come due, so scheduled requests follow
+the simulation (they wait while the game is paused) and cost
+nothing until then. Requests are kept in a binary min-heap
+ordered by due tick, then by priority class, then by the
+order they were scheduled in. A request scheduled for a tick
+that has already been reached runs on the next Advance, as
+do requests scheduled by a request while it runs. Closures
+are stored as they are in Queue; entries are recycled and
+only freed by Destroy. */
+enum SCHEDULE_PRIORITY
+{
+	SCHEDULE_High,
+	SCHEDULE_Normal,
+	SCHEDULE_Low,
+};
+struct SCHEDULE_ENTRY
+{
+	DWORD Due; // Tick to run on
+	DWORD Priority; // See SCHEDULE_PRIORITY
+	DWORD Sequence;
+	SCHEDULE_ENTRY * pNextFree;
+	void (*pfnInvoke)(void *);
+	void (*pfnDestroy)(void *);
+	union
+	{
+		unsigned char Storage[QUEUE_CLOSURE_SIZE];
+		double AlignDouble;
+		void * AlignPointer;
+	};
+};
+struct SCHEDULER
+{
+	int Initialise();
+	int Destroy();
+	template <typename T> BOOL RunAt( DWORD Tick, const T & Closure, DWORD Priority = SCHEDULE_Normal );
+	template <typename T> BOOL RunAfter( DWORD Milliseconds, const T & Closure, DWORD Priority = SCHEDULE_Normal );
+	void Advance();
+	void Clear();
+	DWORD GetTick();
+	DWORD GetPendingCount();
+
+	SCHEDULE_ENTRY * Allocate();
+	BOOL Push(SCHEDULE_ENTRY*, DWORD, DWORD);
+	void Release(SCHEDULE_ENTRY*);
+	bool Before(SCHEDULE_ENTRY*, SCHEDULE_ENTRY*);
+
+	SCHEDULE_ENTRY ** Heap;
+	DWORD HeapSize;
+	DWORD HeapCapacity;
+	SCHEDULE_ENTRY * pFree; // Recycled entries
+	DWORD Now; // Ticks advanced since Initialise
+	DWORD Sequence; // Entries scheduled since Initialise
+};
+template <typename T>
+BOOL SCHEDULER::RunAt( DWORD Tick, const T & Closure, DWORD Priority )
+{
+	SCHEDULE_ENTRY * pEntry = this->Allocate();
+	if( !pEntry ) return FALSE;
+
+	if( sizeof(T) <= QUEUE_CLOSURE_SIZE && __alignof(T) <= __alignof(double) )
+	{
+		new(pEntry->Storage) T( Closure );
+		pEntry->pfnInvoke = QUEUE_CLOSURE<T>::Invoke;
+		pEntry->pfnDestroy = QUEUE_CLOSURE<T>::Destroy;
+	}
+	else
+	{
+		T * pHeap = new(std::nothrow) T( Closure );
+		if( !pHeap )
+		{
+			pEntry->pNextFree = this->pFree;
+			this->pFree = pEntry;
+			return FALSE;
+		}
+		*(T **)pEntry->Storage = pHeap;
+		pEntry->pfnInvoke = QUEUE_CLOSURE<T>::InvokeHeap;
+		pEntry->pfnDestroy = QUEUE_CLOSURE<T>::DestroyHeap;
+	}
+
+	return this->Push( pEntry, Tick, Priority );
+}
+template <typename T>
+BOOL SCHEDULER::RunAfter( DWORD Milliseconds, const T & Closure, DWORD Priority )
+{
+	// Round up, so a request never runs early
+	DWORD Ticks = DWORD( ( UINT64(Milliseconds)*GOBJ_TICK_RATE + 999 ) / 1000 );
+	return this->RunAt( this->Now + Ticks, Closure, Priority );
+}
+
+
+
+/* GOBJ_ALLOCATOR is a pool of fixed-size blocks.
+Short-lived objects that are created in large numbers
+during play take their memory from the pool of their
+type (see GOBJ_POOL_ALLOCATED) instead of the heap.
+Blocks are carved from chunks which are kept until
+the pool is destroyed, and freed blocks are reused
+first. Every pool keeps usage statistics and links
+itself into a list, so all pools can be reported. */
+class GOBJ_ALLOCATOR
+{
+public:
+	GOBJ_ALLOCATOR( const char * szName, size_t BlockSize, DWORD BlocksPerChunk = 64 );
+	~GOBJ_ALLOCATOR();
+
+	void * Allocate( size_t Size );
+	void Free( void * pBlock, size_t Size );
+
+	static GOBJ_ALLOCATOR * GetFirst();
+	GOBJ_ALLOCATOR * GetNext();
+	static void ReportAll();
+
+	const char * Name;
+	size_t BlockSize;
+	DWORD BlocksPerChunk;
+	DWORD LiveBlocks; // Blocks in use
+	DWORD HighWater; // Most blocks ever in use at once
+	DWORD Capacity; // Blocks in all chunks
+	DWORD Allocations; // Total blocks handed out
+	DWORD Fallbacks; // Requests passed on to the heap
+
+private:
+	void * pFreeList;
+	void * pChunks;
+	GOBJ_ALLOCATOR * pNext;
+	static GOBJ_ALLOCATOR * pFirst;
+};
+/* GOBJ_POOL_ALLOCATED(T) gives the structure T class-
+specific 'new' and 'delete' operators that use the pool
+named 'Allocator', which must be defined once for T:
+	GOBJ_ALLOCATOR T::Allocator( "T", sizeof(T) );
+Since the destructor of GOBJ_PARENT is virtual, the
+'delete this' in GOBJ_PARENT::Destroy returns the
+memory to the pool of the object's own type. A type
+derived from a pooled type without a pool of its own
+is larger than the blocks, and goes to the heap. The
+class-scope 'new' hides the global ones, so a pooled
+type can only be made with 'new(std::nothrow) T'. */
+#define GOBJ_POOL_ALLOCATED(T) \
+	static GOBJ_ALLOCATOR Allocator; \
+	static void * operator new( size_t Size, const std::nothrow_t& ) throw() { \
+		return Allocator.Allocate( Size ); } \
+	static void operator delete( void * p, const std::nothrow_t& ) throw() { \
+		Allocator.Free( p, sizeof(T) ); } \
+	static void operator delete( void * p, size_t Size ) { \
+		Allocator.Free( p, Size ); }
+
+
+
+/* This is an enumeration of object IDs. */
+enum GOBJID
+{
+	GOBJID_Null,
+	// Time tracker
+	GOBJID_TimeTracker,
+	// Game contexts
+	GOBJID_CONTEXT_MainMenu,
+	GOBJID_CONTEXT_PauseMenu,
+	GOBJID_CONTEXT_HelpScreen,
+	GOBJID_CONTEXT_OptionsMenu,
+	GOBJID_CONTEXT_MainGame,
+	GOBJID_CONTEXT_Loading,
+	// User interface objects
+	GOBJID_GAME_UI_StartGame,
+	GOBJID_GAME_UI_HowToPlay,
+	GOBJID_GAME_UI_Options,
+	GOBJID_GAME_UI_Exit,
+	// Mowers
+	GOBJID_GAME_MowerMonster,
+	GOBJID_GAME_MowerMover,
+	GOBJID_GAME_MowerMini,
+	// Others
+	GOBJID_GAME_GrassTile,
+	GOBJID_GAME_Gnome,
+	GOBJID_GAME_StoneOrnament,
+	GOBJID_GAME_Tree,
+	GOBJID_GAME_TreeBeehive,
+	GOBJID_GAME_Cat,
+	GOBJID_GAME_Dog,
+	GOBJID_GAME_RabbitHelper,
+	GOBJID_GAME_MoleHill,
+	// Number of object IDs
+	GOBJID_Count,
+};
+
+
+
+/* The following are declarations of structures. Eventually
+they will represent the structure of blocks of memory allocated
+in the RAM (Random Access Memory). The first structure is an
+abstract structure, which serves as a base structure from which
+other structures derive from, known as a 'parent-child'
+relationship.
+All derivative structures will contain four basic methods:
+- GetObjId() (returns to the calling thread the ID of the object
+as defined in the enumeration above)
+- Initialise() (Initialises all members of the structure to zero)
+- Create() (this method initialises the structure for use later)
+- Destroy() (this method prepares the structure for deletion and
+then deletes the structure from memory) */
+struct GOBJ_PARENT
+{
+	/* Base structure */
+	virtual ~GOBJ_PARENT() {}
+	virtual int GetObjId()		= 0;
+	virtual int Initialise()	= 0;
+	virtual int Create();
+	virtual int Destroy();
+	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);	
+};
+
+
+
+/* Time tracker object. Used for high resolution time tracking.
+The game is simulated in fixed ticks of 1/GOBJ_TICK_RATE
+seconds, however fast frames are rendered. Update adds the
+real time since the previous frame to an accumulator, and
+Tick then returns true once for each whole tick it holds.
+What is left over is given as 'Alpha', the fraction of a
+tick by which rendering should blend from the previous to
+the current state. */
+struct GOBJ_TimeTracker : GOBJ_PARENT
+{
+	int GetObjId();
+	int Initialise();
+	int Update();
+	bool Tick();
+
+	UINT64 Frequency;
+	UINT64 PreviousCount;
+	UINT64 Elapsed; // Counts since the previous Update
+	UINT64 Accumulator; // Counts not yet simulated
+	UINT64 TickLength; // Counts per tick
+	DWORD TickRate; // Ticks per second, always GOBJ_TICK_RATE
+	DWORD MaxTicks; // Most ticks simulated per frame
+	float Alpha;
+};
+
+
+
+/* GOBJ_HANDLE is a generation-checked reference to
+an object registered with a context. Unlike a pointer,
+a handle can be tested after the object has gone: once
+the object is unregistered (for example a gnome which
+has destroyed itself) the generation of its slot
+changes and the handle no longer resolves. A handle
+whose generation is zero refers to nothing. */
+struct GOBJ_HANDLE
+{
+	DWORD Index;
+	DWORD Generation;
+};
+
+
+
+/* GOBJ_GAME is an abstract structure which
+game objects derive from. */
+struct GOBJ_GAME : GOBJ_PARENT
+{
+	GOBJ_GAME();
+
+	virtual int Update();
+	virtual int Render();
+	virtual int Keyboard();
+	virtual int Mouse();
+	virtual bool IsPooled();
+
+	GOBJ_HANDLE Handle; // Set while registered with a context
+	bool		Killed; // Set once queued by GOBJ_CONTEXT::KillObject
+	DWORD		Kind; // Object ID, cached while registered
+	GOBJ_GAME * pPrevOfKind; // Registered objects of the same kind
+	GOBJ_GAME * pNextOfKind;
+};
+
+
+
+struct GOBJ_COMPONENTS;
+/* GOBJ_GAME_POOLED is an abstract structure which
+game objects derive from when their per-frame data
+(position, velocity, mesh and flags) is kept in the
+component store of the context instead of inside the
+object itself. The object is then only a view over
+row 'Slot' of the store 'pStore'. Pooled objects
+receive their row when they are registered with a
+context, so they must be registered before they are
+initialised. */
+struct GOBJ_GAME_POOLED : GOBJ_GAME
+{
+	GOBJ_GAME_POOLED();
+
+	virtual int Destroy();
+	virtual bool IsPooled();
+
+	GOBJ_COMPONENTS * pStore;
+	DWORD Slot;
+};
+
+
+
+/* GOBJ_COMPONENTS is a structure-of-arrays store for
+one kind of pooled game object. Each component lives
+in its own contiguous array, so that a pass over every
+object of one kind (for example every grass tile) is a
+linear sweep over memory rather than a walk through
+scattered heap objects.
+Rows are kept packed: removing a row moves the last
+row into its place and updates the owner's 'Slot'.
+The store owns the mesh reference held in each row.
+The context takes a snapshot of every position at the
+start of each tick, so that renderers can blend between
+the two (see GetRenderPosition). */
+struct GOBJ_COMPONENTS
+{
+	int Initialise();
+	int Destroy();
+	int Reserve(DWORD);
+	int Insert(GOBJ_GAME_POOLED*);
+	int Remove(GOBJ_GAME_POOLED*);
+	void Snapshot();
+	void GetRenderPosition(DWORD Row, float Alpha, float * pOut);
+
+	DWORD Count;
+	DWORD Capacity;
+	GOBJ_GAME_POOLED ** Owner;
+	Resource_Mesh ** Mesh;
+	float * PosX;
+	float * PosY;
+	float * PosZ;
+	float * PrevX; // Position at the start of the tick, or
+	float * PrevY; // FLT_MAX in PrevX until the first tick
+	float * PrevZ;
+	float * VelX;
+	float * VelY;
+	float * VelZ;
+	float * Scale; // Squash scale
+	DWORD * FrameCount;
+	bool * Flag; // Mowed or smashed
+};
+
+
+
+/* GOBJ_KERNEL is a non-virtual function that updates or
+renders the rows [First, First+Count) of a component
+store. Pooled types implement their behaviour as such
+kernels, so that a whole store can be processed in one
+call (see GOBJ_CONTEXT::SetKernels), while their virtual
+methods simply run the kernel over their own row. */
+typedef int (*GOBJ_KERNEL)(GOBJ_COMPONENTS&, DWORD First, DWORD Count);
+struct GOBJ_KERNELS
+{
+	GOBJ_KERNEL Update; // May be null if the kind does nothing
+	GOBJ_KERNEL Render;
+	bool Batched;
+};
+
+
+
+/* GOBJ_SLOT is an entry in the slot table of a context.
+While in use it holds the position of its object in the
+packed object list; while free it holds the next free
+slot. */
+struct GOBJ_SLOT
+{
+	DWORD Index;
+	DWORD Generation;
+};
+
+
+
+/* GOBJ_CONTEXT is an abstract structure which
+game contexts derive from. Game contexts handle
+what happens in a game.
+Registered objects are kept packed at the front of
+'ObjectList', so passes never meet empty entries.
+Objects are found through a slot table with a free
+list, which makes registering and unregistering O(1);
+unregistering moves the last object into the hole.
+Objects must not be unregistered during a pass. An
+object that is finished with (itself or another) is
+handed to KillObject instead; the kill list is flushed
+once per frame by FlushKills, which closes all holes
+in a single pass and then destroys the objects.
+Pooled kinds whose kernels have been set are batched:
+their objects are kept behind the others in the list
+(from 'ListVirtual' on) and are skipped by the passes,
+which instead run each kind's kernel over its store
+once. Batched objects receive no input.
+Registered objects are also linked into a list per
+object ID, so the objects of a kind are found without
+scanning (see GetFirstObject and pNextOfKind).
+Each context has a scheduler of its own, advanced at the
+start of every Update, so requests it holds are dropped
+with the context. ExpireObject uses it to kill an object
+a number of ticks from now, unless it has gone by then. */
+struct GOBJ_CONTEXT : GOBJ_PARENT
+{
+	virtual int Initialise();
+	virtual int Destroy();
+	virtual int Update();
+	virtual int Render();
+	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	virtual int Keyboard();
+	virtual int Mouse();
+	int RegisterObject(GOBJ_GAME*, GOBJ_HANDLE* = nullptr);
+	int UnregisterObject(GOBJ_GAME*);
+	int ReplaceObject(GOBJ_GAME*, GOBJ_GAME*);
+	int DestroyObject(GOBJ_GAME*);
+	int DestroyAllObjects();
+	int KillObject(GOBJ_GAME*);
+	int ExpireObject(GOBJ_GAME*, DWORD);
+	int FlushKills();
+	GOBJ_GAME * ResolveHandle(GOBJ_HANDLE);
+	bool IsAlive(GOBJ_HANDLE);
+	GOBJ_GAME * GetFirstObject(DWORD);
+	DWORD GetObjectCount(DWORD);
+	int SetKernels(DWORD, GOBJ_KERNEL, GOBJ_KERNEL);
+	bool IsBatched(GOBJ_GAME*);
+	void RetireSlot(DWORD);
+	void MoveEntry(DWORD, DWORD);
+	void LinkKind(GOBJ_GAME*);
+	void UnlinkKind(GOBJ_GAME*);
+
+	GOBJ_GAME** ObjectList; // Packed list of registered objects
+	DWORD		ListSize; // Number of registered objects
+	DWORD		ListVirtual; // Number of objects that are not batched
+	DWORD		ListCapacity;
+	DWORD *		ListSlot; // Slot of each entry in ObjectList
+	GOBJ_SLOT *	Slots;
+	DWORD		SlotCount;
+	DWORD		FreeSlot; // Head of the free list
+	GOBJ_GAME**	KillList; // Objects to destroy at the end of the frame
+	DWORD		KillCount;
+	DWORD		KillCapacity;
+	GOBJ_COMPONENTS Components[GOBJID_Count]; // Indexed by object ID
+	GOBJ_KERNELS	Kernels[GOBJID_Count]; // Indexed by object ID
+	GOBJ_GAME *		FirstOfKind[GOBJID_Count]; // Indexed by object ID
+	DWORD			CountOfKind[GOBJID_Count];
+	SCHEDULER		Schedule; // Advanced once per tick by Update
+};
+/* GOBJ_CONTEXT_MainMenu is a structure which handles
+what goes on when the Main Menu screen is active. */
+struct GOBJ_CONTEXT_MainMenu : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Create();
+
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+/* GOBJ_CONTEXT_HelpScreen is a structure which handles
+what goes on when the help screen is active. */
+struct GOBJ_CONTEXT_HelpScreen : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Initialise();
+
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+
+	WORD page;
+};
+/* GOBJ_CONTEXT_OptionsMenu is a structure which handles
+what goes on when the options screen is active. */
+struct GOBJ_CONTEXT_OptionsMenu : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Create();
+
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+/* GOBJ_CONTEXT_PauseMenu is a structure which handles
+what goes on when the game becomes paused and a menu
+appears. */
+struct GOBJ_CONTEXT_PauseMenu : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Destroy();
+
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+
+	GOBJ_CONTEXT * pPrevious;
+};
+/* GOBJ_CONTEXT_Loading is a structure which handles what
+goes on while the meshes of the main game load in the
+background. It shows how many have loaded, and starts the
+first level once they all have. */
+#define LOADING_MAX_TICKETS 16
+struct GOBJ_CONTEXT_Loading : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Create();
+	int Destroy();
+
+	int Update();
+	int Render();
+
+	RESOURCE_TICKET Tickets[LOADING_MAX_TICKETS];
+	DWORD TicketCount;
+	bool IsDone; // The first level has been queued
+};
+/* The states of a level of the main game. Once a level is
+won or lost, the lawn freezes and a panel shows the outcome;
+the main loop keeps running, and the next request is queued
+once the player presses the key the panel asks for. */
+enum MAINGAME_STATE
+{
+	MAINGAME_Playing,
+	MAINGAME_LevelComplete, // ENTER goes on to OnLevelCompletion
+	MAINGAME_TimeUp, // ENTER returns to the main menu
+	MAINGAME_NoLives, // ENTER returns to the main menu
+	MAINGAME_GameComplete, // SPACE returns to the main menu
+	MAINGAME_Leaving, // The next request has been queued
+};
+
+/* GOBJ_CONTEXT_MainGame is a structure which handles
+what goes on when the 'New Game' button is selected. */
+struct GOBJ_CONTEXT_MainGame : GOBJ_CONTEXT
+{
+	int GetObjId();
+	int Create();
+
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Update();
+	int Render();
+
+	void Congratulations();
+	void TimeoutGameover();
+	void NoLivesGameover();
+	void UpdateWaiting();
+	void RenderPanel();
+
+	int Destroy();
+
+	void ResetCoverage();
+	void ValidateCoverage();
+	int LayLawn();
+	int RenderLawn();
+	void UpdateBroadphase();
+
+	int (__stdcall *OnLevelCompletion)();
+	DWORD State; // See MAINGAME_STATE
+	long score;
+	DWORD TileWidth; // Width extent of tiles from centre
+	DWORD TileHeight; // Height extent of tiles from centre
+	DWORD dwNumTiles; // Running count of grass tiles
+	DWORD dwNumMowedTiles; // Running count of mowed grass tiles
+	LAWN Lawn; // Cut grass tiles, one bit each
+	Resource_Mesh * pGrassMesh; // Drawn for every tile of the lawn
+	SWEEP_AND_PRUNE Broadphase; // Mowers against obstacles
+	float fGrassCut;
+	DWORD dwTimer; // Frames left before timeout
+	DWORD dwLives; // Lives left
+	D3DXVECTOR3 vecFarView; // Level-specific view position
+};
+
+
+
+/* GOBJ_BUTTON is a base structure from which button
+objects will inherit. */
+struct GOBJ_BUTTON : GOBJ_GAME
+{
+	virtual int Initialise();
+	virtual int Create();
+	virtual int Update();
+	virtual int Render();
+
+	RECT Position;
+	IDirect3DTexture9 *pFace;
+	bool IsAvailable;
+	RESOURCE_HANDLE hFaceInactive;
+	RESOURCE_HANDLE hFaceActive;
+	RESOURCE_HANDLE hFacePressed;
+	RESOURCE_HANDLE hFaceDisabled;
+	RESOURCE_HANDLE hSndHover;
+};
+/* GOBJ_BUTTON_StartGame is the structure which
+will become the Start Game button in the main menu. */
+struct GOBJ_BUTTON_StartGame : GOBJ_BUTTON
+{
+	int GetObjId();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+/* GOBJ_BUTTON_Options is the structure which
+will become the Options button in the main menu. */
+struct GOBJ_BUTTON_Options : GOBJ_BUTTON
+{
+	int GetObjId();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+/* GOBJ_BUTTON_Exit is the structure which
+will become the Exit button in the main menu. */
+struct GOBJ_BUTTON_Exit : GOBJ_BUTTON
+{
+	int GetObjId();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+/* GOBJ_BUTTON_Help is the structure which
+will become the help button in the main menu. */
+struct GOBJ_BUTTON_Help : GOBJ_BUTTON
+{
+	int GetObjId();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	int Render();
+};
+
+
+
+/* GOBJ_SLIDER is a base structure from which slider
+user interface objects will derive. */
+struct GOBJ_SLIDER : GOBJ_GAME
+{
+	virtual int Initialise();
+	virtual int MsgProc(HWND,UINT,WPARAM,LPARAM);
+	virtual int Update();
+	virtual int Render();
+
+	virtual int OnDrag();
+	virtual int OnRelease();
+
+	DWORD BackColour;
+	DWORD FrontColour;
+	RECT Position;
+	float fSetting;
+	bool IsDragged;
+};
+/* GOBJ_SLIDER_MusicVolume is the structure which
+will become the music volume adjuster. */
+struct GOBJ_SLIDER_MusicVolume : GOBJ_SLIDER
+{
+	int GetObjId();
+	int Create();
+
+	int OnDrag();
+
+	RESOURCE_HANDLE hMusic;
+};
+/* GOBJ_SLIDER_GrassDensity is the structure which
+will become the grass density adjuster. */
+struct GOBJ_SLIDER_GrassDensity : GOBJ_SLIDER
+{
+	int GetObjId();
+	int Create();
+
+	int OnDrag();
+	int OnRelease();
+};
+
+
+
+/* GOBJ_FloatingText is the structure which
+will become text which makes an appearance
+on screen before shortly disappearing. */
+struct GOBJ_FloatingText : GOBJ_GAME
+{
+	GOBJ_POOL_ALLOCATED(GOBJ_FloatingText)
+
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	ID3DXFont *pFont;
+	CString TextString;
+	DWORD dwColour;
+	DWORD dwInitFrameCount;
+	DWORD dwFrameCount;
+	DWORD dwAnimStage;
+	float Position[3];
+	float Velocity[3];
+};
+
+
+
+/* GOBJ_GAME_MOWER is a base structure from
+which mowers will derive. */
+struct GOBJ_GAME_MOWER : GOBJ_GAME
+{
+	virtual int Initialise();
+	virtual int Destroy();
+	virtual int Update();
+	virtual int Render();
+
+	virtual float GetAxialExtents() = 0; // 'Axial Extent' = extent from center x 2
+	virtual float GetAxialAcceleration() = 0;
+
+	void CollideWith(GOBJ_GAME_POOLED*);
+	static void OnBroadphasePair(void*,void*,void*);
+
+	Resource_Mesh * pMesh;
+	float Position[3];
+	float PrevPosition[3]; // Position at the start of the update
+	float Velocity[3];
+	float Facing[3];
+};
+/* GOBJ_GAME_MowerMini is the structure which
+will represent the Mini Mower. */
+struct GOBJ_GAME_MowerMini : GOBJ_GAME_MOWER
+{
+	int GetObjId();
+	int Create();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+
+	float GetAxialExtents();
+	float GetAxialAcceleration();
+};
+/* GOBJ_GAME_MowerMover is the structure which
+will represent the Mover mower. */
+struct GOBJ_GAME_MowerMover : GOBJ_GAME_MOWER
+{
+	int GetObjId();
+	int Create();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+
+	float GetAxialExtents();
+	float GetAxialAcceleration();
+};
+/* GOBJ_GAME_MowerMonster is the structure which
+will represent the Monster mower. */
+struct GOBJ_GAME_MowerMonster : GOBJ_GAME_MOWER
+{
+	int GetObjId();
+	int Create();
+	int MsgProc(HWND,UINT,WPARAM,LPARAM);
+
+	float GetAxialExtents();
+	float GetAxialAcceleration();
+};
+
+
+
+/* GOBJ_GAME_Gnome is the structure which
+will represent a gnome. */
+struct GOBJ_GAME_Gnome : GOBJ_GAME_POOLED
+{
+	GOBJ_POOL_ALLOCATED(GOBJ_GAME_Gnome)
+
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Update();
+	int Render();
+
+	static int UpdateRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+	static int RenderRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+};
+/* GOBJ_GAME_StoneOrnament is the structure which
+will represent a stone ornament. */
+struct GOBJ_GAME_StoneOrnament : GOBJ_GAME_POOLED
+{
+	GOBJ_POOL_ALLOCATED(GOBJ_GAME_StoneOrnament)
+
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Update();
+	int Render();
+
+	static int UpdateRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+	static int RenderRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+};
+/* GOBJ_GAME_Tree is the structure which
+will represent a tree obstacle. */
+struct GOBJ_GAME_Tree : GOBJ_GAME
+{
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	Resource_Mesh * pMesh;
+	DWORD FrameCount;
+	float Position[3];
+};
+/* GOBJ_GAME_TreeBeehive is the structure which
+will represent a tree obstacle. */
+struct GOBJ_GAME_TreeBeehive : GOBJ_GAME
+{
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	Resource_Mesh * pMesh;
+	DWORD FrameCount;
+	float Position[3];
+	bool IsDisturbed;
+};
+/* GOBJ_GAME_Cat is the structure which
+will represent an obstacle. */
+struct GOBJ_GAME_Cat : GOBJ_GAME
+{
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	Resource_Mesh * pMesh;
+	DWORD FrameCount;
+	float Position[3];
+	float Velocity[3];
+	bool IsDisturbed;
+};
+/* GOBJ_GAME_Dog is the structure which
+will represent an obstacle. */
+struct GOBJ_GAME_Dog : GOBJ_GAME
+{
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	Resource_Mesh * pMesh;
+	DWORD FrameCount;
+	float Position[3];
+	float Velocity[3];
+	bool IsDisturbed;
+};
+/* GOBJ_GAME_RabbitHelper is the structure which
+will represent a rabbit. */
+struct GOBJ_GAME_RabbitHelper : GOBJ_GAME
+{
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Destroy();
+	int Update();
+	int Render();
+
+	Resource_Mesh * pMesh;
+	DWORD FrameCount;
+	float Position[3];
+	float Velocity[3];
+	float Facing[3];
+};
+/* GOBJ_GAME_MoleHill is the structure which
+will represent a molehill. */
+struct GOBJ_GAME_MoleHill : GOBJ_GAME_POOLED
+{
+	GOBJ_POOL_ALLOCATED(GOBJ_GAME_MoleHill)
+
+	int GetObjId();
+	int Initialise();
+	int Create();
+	int Update();
+	int Render();
+
+	static int UpdateRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+	static int RenderRows(GOBJ_COMPONENTS&, DWORD, DWORD);
+};
+
@@ -1,170 +1,1030 @@
-
-
-
-#include "GameResource.h"
-
-
-
-ResourceManager::ResourceManager()
-{
-	this->Pool = nullptr;
-	this->PoolSize = 0;
-}
-ResourceManager::~ResourceManager()
-{
-	if( this->Pool )
-	{
-		for( DWORD i = 0; i < this->PoolSize; i++ )
-		{
-			if( this->Pool[i] )
-			{
-				this->Pool[i]->Release();
-				this->Pool[i] = nullptr;
-			}
-		}
-		delete[] this->Pool;
-		Pool = nullptr;
-	}
-	PoolSize = 0;
-}
-int ResourceManager::AddResource(Resource * resource, LPSTR name)
-{
-	if( !this->Pool )
-	{
-		this->Pool = new(std::nothrow) Resource *[32]();
-		if( !this->Pool )
-		{
-			return E_OUTOFMEMORY;
-		}
-		this->PoolSize = 32;
-		this->Pool[0] = resource;
-		DWORD len = strlen( name ) + 1;
-		LPSTR NewString = new char[len];
-		memcpy(NewString,name,len);
-		resource->Name = NewString;
-		resource->AddRef();
-		return S_OK;
-	}
-
-	for( DWORD i = 0; i < this->PoolSize; i++ )
-	{
-		if( !this->Pool[i] )
-		{
-			this->Pool[i] = resource;
-			DWORD len = strlen( name ) + 1;
-			LPSTR NewString = new char[len];
-			memcpy(NewString,name,len);
-			resource->Name = NewString;
-			resource->AddRef();
-			return S_OK;
-		}
-	}
-
-	{
-		DWORD OldSize = this->PoolSize;
-		if( FAILED( this->PoolExpand( 32 ) ) )
-		{
-			return E_OUTOFMEMORY;
-		}
-		this->Pool[OldSize] = resource;
-		DWORD len = strlen( name ) + 1;
-		LPSTR NewString = new char[len];
-		memcpy(NewString,name,len);
-		resource->Name = NewString;
-		resource->Name = NewString;
-		resource->AddRef();
-
-		return S_OK;
-	}
-}
-Resource * ResourceManager::GetResourceByName(LPSTR name)
-{
-	if( this->Pool && name )
-	{
-		for( DWORD i = 0; i < this->PoolSize; i++ )
-		{
-			if( this->Pool[i] )
-				if( this->Pool[i]->Name )
-					if( strcmp( name, this->Pool[i]->GetName() ) == 0 )
-						return this->Pool[i];
-		}
-	}
-	return nullptr;
-}
-int ResourceManager::ReleaseResource(Resource * resource)
-{
-	if( this->Pool )
-	{
-		for( DWORD i = 0; i < this->PoolSize; i++ )
-		{
-			if( this->Pool[i] == resource )
-			{
-				this->Pool[i] = nullptr;
-				resource->Release();
-				return S_OK;
-			}
-		}
-	}
-
-	return S_OK;
-}
-int ResourceManager::PoolExpand(DWORD BySize)
-{
-	Resource ** pNewList;
-	DWORD dwNewSize = this->PoolSize + BySize;
-	pNewList = new(std::nothrow) Resource *[dwNewSize]();
-	if( !pNewList ) return E_OUTOFMEMORY;
-
-	if( this->Pool )
-	{
-		memcpy( pNewList, this->Pool, this->PoolSize * sizeof(Resource *) );
-		delete[] this->Pool;
-	}
-
-	this->Pool = pNewList;
-	this->PoolSize = dwNewSize;
-
-	return S_OK;
-}
-int ResourceManager::PoolResize(DWORD NewSize)
-{
-	int diff = NewSize - this->PoolSize;
-
-	if( diff > 0 )
-	{
-		PoolExpand( diff );
-	}
-
-	return S_OK;
-}
-
-
-
-Resource::Resource()
-{
-	this->RefCount = 1;
-	this->Name = nullptr;
-}
-Resource::~Resource()
-{
-}
-int Resource::AddRef()
-{
-	this->RefCount ++;
-	return this->RefCount;
-}
-int Resource::Release()
-{
-	DWORD NewRefCount = -- this->RefCount;
-	if( this->RefCount == 0 )
-	{
-		delete[] this->Name;
-		delete this;
-	}
-	return NewRefCount;
-}
-LPSTR Resource::GetName()
-{
-	return this->Name;
-}
-
+
+
+
+#include "GameResource.h"
+#include "Profile.h"
+#include "FramePacer.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <stdio.h>
+#include <stdarg.h>
+#ifdef MOWVE_IT_BENCHMARK
+#include <stdlib.h>
+#endif
+
+
+
+struct RESOURCE_LOADERS
+{
+	RESOURCE_LOADERS()
+	{
+		this->pQueued = nullptr;
+		this->ppQueuedTail = &this->pQueued;
+		this->pDecoded = nullptr;
+		this->ppDecodedTail = &this->pDecoded;
+		this->Threads = nullptr;
+		this->ThreadCount = 0;
+		this->Stopping = false;
+		this->Pending.store( 0, std::memory_order_relaxed );
+	}
+
+	std::mutex Lock; // Guards the rest, except Pending
+	std::condition_variable Queued; // A load was queued, or the threads should stop
+	std::condition_variable Decoded; // A load was decoded
+	RESOURCE_LOAD * pQueued; // Oldest first
+	RESOURCE_LOAD ** ppQueuedTail;
+	RESOURCE_LOAD * pDecoded; // Oldest first
+	RESOURCE_LOAD ** ppDecodedTail;
+	std::thread * Threads;
+	DWORD ThreadCount;
+	bool Stopping;
+	std::atomic<DWORD> Pending; // Loads not yet complete
+};
+
+static void AppendLoad( RESOURCE_LOAD **& ppTail, RESOURCE_LOAD * pLoad )
+{
+	pLoad->pNext = nullptr;
+	*ppTail = pLoad;
+	ppTail = &pLoad->pNext;
+}
+static RESOURCE_LOAD * PopLoad( RESOURCE_LOAD *& pHead, RESOURCE_LOAD **& ppTail )
+{
+	RESOURCE_LOAD * pLoad = pHead;
+	if( pLoad )
+	{
+		pHead = pLoad->pNext;
+		if( !pHead ) ppTail = &pHead;
+	}
+	return pLoad;
+}
+
+
+
+ResourceManager::ResourceManager()
+{
+	InitializeSRWLock( &this->AccessLock );
+	this->pPool.store( nullptr, std::memory_order_relaxed );
+	this->pIndex.store( nullptr, std::memory_order_relaxed );
+	this->ResourceCount = 0;
+	this->FreeHint = 0;
+	this->IndexUsed = 0;
+	this->LockAcquires.store( 0, std::memory_order_relaxed );
+	this->LockContended.store( 0, std::memory_order_relaxed );
+	this->LockWaitCounts.store( 0, std::memory_order_relaxed );
+	this->pLoaders = new(std::nothrow) RESOURCE_LOADERS();
+	this->CacheBudget = 0;
+	this->CacheBytes = 0;
+	this->pCacheHead = nullptr;
+	this->pCacheTail = nullptr;
+	memset( this->CacheStats, 0, sizeof(this->CacheStats) );
+}
+ResourceManager::~ResourceManager()
+{
+	if( this->pLoaders )
+	{
+		this->StopLoaders();
+		this->UpdateLoads( (DWORD)-1 );
+		delete this->pLoaders;
+		this->pLoaders = nullptr;
+	}
+
+	while( this->pCacheHead )
+	{
+		Resource * pResource = this->pCacheHead;
+		this->CacheUnlink( pResource );
+		pResource->Release();
+	}
+
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_acquire );
+	if( pPool )
+	{
+		for( DWORD i = 0; i < pPool->Size; i++ )
+		{
+			Resource * pResource = pPool->Slots[i].pResource.load( std::memory_order_relaxed );
+			if( pResource )
+			{
+				pResource->Release();
+				pPool->Slots[i].pResource.store( nullptr, std::memory_order_relaxed );
+			}
+		}
+	}
+	while( pPool )
+	{
+		RESOURCE_POOL * pRetired = pPool->pRetired;
+		delete[] pPool->Slots;
+		delete pPool;
+		pPool = pRetired;
+	}
+	RESOURCE_INDEX * pIndex = this->pIndex.load( std::memory_order_acquire );
+	while( pIndex )
+	{
+		RESOURCE_INDEX * pRetired = pIndex->pRetired;
+		delete[] pIndex->Entries;
+		delete pIndex;
+		pIndex = pRetired;
+	}
+	this->pPool.store( nullptr, std::memory_order_relaxed );
+	this->pIndex.store( nullptr, std::memory_order_relaxed );
+}
+void ResourceManager::Lock()
+{
+	if( !TryAcquireSRWLockExclusive( &this->AccessLock ) )
+	{
+		unsigned long long Start = CTimer::Now();
+		AcquireSRWLockExclusive( &this->AccessLock );
+		this->LockContended.fetch_add( 1, std::memory_order_relaxed );
+		this->LockWaitCounts.fetch_add( CTimer::Now() - Start, std::memory_order_relaxed );
+	}
+	this->LockAcquires.fetch_add( 1, std::memory_order_relaxed );
+}
+void ResourceManager::Unlock()
+{
+	ReleaseSRWLockExclusive( &this->AccessLock );
+}
+void ResourceManager::GetLockStats(RESOURCE_LOCK_STATS * pOut)
+{
+	pOut->Acquires = this->LockAcquires.load( std::memory_order_relaxed );
+	pOut->Contended = this->LockContended.load( std::memory_order_relaxed );
+	pOut->WaitMilliseconds = double( this->LockWaitCounts.load( std::memory_order_relaxed ) ) *
+		1000.0 / double( CTimer::Frequency() );
+}
+DWORD ResourceManager::HashName(LPCSTR name)
+{
+	// FNV-1a
+	DWORD Hash = 2166136261u;
+	while( *name )
+	{
+		Hash ^= (BYTE)*name++;
+		Hash *= 16777619u;
+	}
+	return Hash;
+}
+int ResourceManager::AddResource(Resource * resource, LPSTR name)
+{
+	// Copy and hash the name before taking the lock
+	DWORD len = strlen( name ) + 1;
+	LPSTR NewString = new(std::nothrow) char[len];
+	if( !NewString ) return E_OUTOFMEMORY;
+	memcpy(NewString,name,len);
+	resource->Name = NewString;
+	resource->NameHash = HashName( NewString );
+	resource->AddRef();
+
+	this->Lock();
+	int hr = this->Insert( resource );
+	this->Unlock();
+
+	if( FAILED( hr ) )
+		resource->Release();
+
+	return hr;
+}
+int ResourceManager::Insert(Resource * resource)
+{
+	// Find a free place, growing the pool if there is none
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_relaxed );
+	DWORD Size = pPool ? pPool->Size : 0;
+	DWORD i = this->FreeHint;
+	while( i < Size && pPool->Slots[i].pResource.load( std::memory_order_relaxed ) )
+		i++;
+	if( i == Size )
+	{
+		if( FAILED( this->PoolGrow( Size < 32 ? 32 : Size*2 ) ) )
+			return E_OUTOFMEMORY;
+		pPool = this->pPool.load( std::memory_order_relaxed );
+	}
+
+	// Keep the index at most half full
+	RESOURCE_INDEX * pIndex = this->pIndex.load( std::memory_order_relaxed );
+	if( !pIndex || (this->IndexUsed + 1)*2 > pIndex->Capacity )
+	{
+		// Removed entries are dropped, so this may not need to grow
+		DWORD dwNewSize = pIndex ? pIndex->Capacity : 64;
+		while( dwNewSize < (this->ResourceCount + 1)*4 )
+			dwNewSize *= 2;
+		if( FAILED( this->IndexRebuild( dwNewSize ) ) )
+			return E_OUTOFMEMORY;
+	}
+
+	// Publish the place, then the index entry that leads to it
+	pPool->Slots[i].pResource.store( resource, std::memory_order_release );
+	this->FreeHint = i + 1;
+	this->ResourceCount ++;
+	this->IndexInsert( resource->NameHash, i );
+
+	return S_OK;
+}
+Resource * ResourceManager::GetResourceByName(LPSTR name)
+{
+	TRACE_SCOPE( "ResourceManager::GetResourceByName" );
+
+	DWORD i = this->FindByName( name );
+	if( i == RESOURCE_INDEX_EMPTY )
+		return nullptr;
+
+	Resource * pResource = this->pPool.load( std::memory_order_acquire )->Slots[i].pResource.load( std::memory_order_acquire );
+	if( pResource )
+		pResource->Lookups.fetch_add( 1, std::memory_order_relaxed );
+	return pResource;
+}
+RESOURCE_HANDLE ResourceManager::GetHandleByName(LPSTR name)
+{
+	RESOURCE_HANDLE hResource = { 0, 0 };
+	DWORD i = this->FindByName( name );
+	if( i != RESOURCE_INDEX_EMPTY )
+	{
+		RESOURCE_SLOT &Slot = this->pPool.load( std::memory_order_acquire )->Slots[i];
+		hResource.Index = i;
+		hResource.Generation = Slot.Generation.load( std::memory_order_acquire );
+		Resource * pResource = Slot.pResource.load( std::memory_order_acquire );
+		if( pResource )
+			pResource->Lookups.fetch_add( 1, std::memory_order_relaxed );
+	}
+	return hResource;
+}
+Resource * ResourceManager::Resolve(RESOURCE_HANDLE hResource)
+{
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_acquire );
+	if( hResource.Generation == 0 || !pPool ||
+		hResource.Index >= pPool->Size )
+		return nullptr;
+
+	RESOURCE_SLOT &Slot = pPool->Slots[hResource.Index];
+	Resource * pResource = Slot.pResource.load( std::memory_order_acquire );
+	if( Slot.Generation.load( std::memory_order_acquire ) != hResource.Generation || !pResource )
+		return nullptr;
+
+	pResource->Resolves.fetch_add( 1, std::memory_order_relaxed );
+	return pResource;
+}
+DWORD ResourceManager::FindByName(LPSTR name)
+{
+	RESOURCE_INDEX * pIndex = this->pIndex.load( std::memory_order_acquire );
+	if( !pIndex || !name )
+		return RESOURCE_INDEX_EMPTY;
+
+	DWORD Hash = HashName( name );
+	DWORD Mask = pIndex->Capacity - 1;
+	for( DWORD e = Hash & Mask; ; e = (e + 1) & Mask )
+	{
+		RESOURCE_INDEX_ENTRY &Entry = pIndex->Entries[e];
+		DWORD i = Entry.Index.load( std::memory_order_acquire );
+		if( i == RESOURCE_INDEX_EMPTY )
+			return RESOURCE_INDEX_EMPTY;
+		if( i == RESOURCE_INDEX_REMOVED || Entry.Hash != Hash )
+			continue;
+
+		// The pool is loaded after the entry, so it is at least as new
+		Resource * pResource = this->pPool.load( std::memory_order_acquire )->Slots[i].pResource.load( std::memory_order_acquire );
+		if( pResource && strcmp( name, pResource->GetName() ) == 0 )
+			return i;
+	}
+}
+int ResourceManager::IndexInsert(DWORD Hash, DWORD Index)
+{
+	RESOURCE_INDEX * pIndex = this->pIndex.load( std::memory_order_relaxed );
+	DWORD Mask = pIndex->Capacity - 1;
+	DWORD e = Hash & Mask;
+	while( pIndex->Entries[e].Index.load( std::memory_order_relaxed ) != RESOURCE_INDEX_EMPTY )
+		e = (e + 1) & Mask;
+	pIndex->Entries[e].Hash = Hash;
+	pIndex->Entries[e].Index.store( Index, std::memory_order_release );
+	this->IndexUsed ++;
+
+	return S_OK;
+}
+int ResourceManager::IndexRebuild(DWORD NewCapacity)
+{
+	RESOURCE_INDEX * pNewIndex = new(std::nothrow) RESOURCE_INDEX;
+	if( !pNewIndex ) return E_OUTOFMEMORY;
+	pNewIndex->Entries = new(std::nothrow) RESOURCE_INDEX_ENTRY[NewCapacity];
+	if( !pNewIndex->Entries )
+	{
+		delete pNewIndex;
+		return E_OUTOFMEMORY;
+	}
+	pNewIndex->Capacity = NewCapacity;
+	for( DWORD e = 0; e < NewCapacity; e++ )
+		pNewIndex->Entries[e].Index.store( RESOURCE_INDEX_EMPTY, std::memory_order_relaxed );
+
+	// Fill the new index before anyone can see it; removed entries are left behind
+	RESOURCE_INDEX * pOldIndex = this->pIndex.load( std::memory_order_relaxed );
+	pNewIndex->pRetired = pOldIndex;
+	DWORD Used = 0;
+	if( pOldIndex )
+	{
+		DWORD Mask = NewCapacity - 1;
+		for( DWORD o = 0; o < pOldIndex->Capacity; o++ )
+		{
+			DWORD i = pOldIndex->Entries[o].Index.load( std::memory_order_relaxed );
+			if( i >= RESOURCE_INDEX_REMOVED ) continue;
+
+			DWORD Hash = pOldIndex->Entries[o].Hash;
+			DWORD e = Hash & Mask;
+			while( pNewIndex->Entries[e].Index.load( std::memory_order_relaxed ) != RESOURCE_INDEX_EMPTY )
+				e = (e + 1) & Mask;
+			pNewIndex->Entries[e].Hash = Hash;
+			pNewIndex->Entries[e].Index.store( i, std::memory_order_relaxed );
+			Used ++;
+		}
+	}
+	this->IndexUsed = Used;
+	this->pIndex.store( pNewIndex, std::memory_order_release );
+
+	return S_OK;
+}
+int ResourceManager::ReleaseResource(Resource * resource)
+{
+	this->Lock();
+
+	// Find the resource's place through its entry in the index
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_relaxed );
+	RESOURCE_INDEX * pIndex = this->pIndex.load( std::memory_order_relaxed );
+	bool bFound = false;
+	if( pIndex )
+	{
+		DWORD Mask = pIndex->Capacity - 1;
+		for( DWORD e = resource->NameHash & Mask; ; e = (e + 1) & Mask )
+		{
+			RESOURCE_INDEX_ENTRY &Entry = pIndex->Entries[e];
+			DWORD i = Entry.Index.load( std::memory_order_relaxed );
+			if( i == RESOURCE_INDEX_EMPTY )
+				break;
+			if( i == RESOURCE_INDEX_REMOVED ||
+				pPool->Slots[i].pResource.load( std::memory_order_relaxed ) != resource )
+				continue;
+
+			// Leave a marker, so that probes carry on past it
+			Entry.Index.store( RESOURCE_INDEX_REMOVED, std::memory_order_release );
+			RESOURCE_SLOT &Slot = pPool->Slots[i];
+			DWORD Generation = Slot.Generation.load( std::memory_order_relaxed ) + 1;
+			Slot.Generation.store( Generation ? Generation : 1, std::memory_order_release );
+			Slot.pResource.store( nullptr, std::memory_order_release );
+			this->ResourceCount --;
+			if( i < this->FreeHint )
+				this->FreeHint = i;
+			bFound = true;
+			break;
+		}
+	}
+
+	// Keep the pool's reference in the cache, if it is worth keeping
+	Resource * pEvicted = nullptr;
+	DWORD Bytes = resource->GetSize();
+	if( bFound && this->CacheBudget && Bytes && Bytes <= this->CacheBudget )
+	{
+		resource->pCachePrev = nullptr;
+		resource->pCacheNext = this->pCacheHead;
+		if( this->pCacheHead ) this->pCacheHead->pCachePrev = resource;
+		else this->pCacheTail = resource;
+		this->pCacheHead = resource;
+		this->CacheBytes += Bytes;
+		this->CacheStats[resource->Type].Cached ++;
+		this->CacheStats[resource->Type].CachedBytes += Bytes;
+		bFound = false;
+
+		pEvicted = this->CacheTrim();
+	}
+
+	this->Unlock();
+
+	if( bFound )
+		resource->Release();
+	while( pEvicted )
+	{
+		Resource * pNext = pEvicted->pCacheNext;
+		pEvicted->Release();
+		pEvicted = pNext;
+	}
+
+	return S_OK;
+}
+void ResourceManager::CacheUnlink(Resource * resource)
+{
+	if( resource->pCachePrev ) resource->pCachePrev->pCacheNext = resource->pCacheNext;
+	else this->pCacheHead = resource->pCacheNext;
+	if( resource->pCacheNext ) resource->pCacheNext->pCachePrev = resource->pCachePrev;
+	else this->pCacheTail = resource->pCachePrev;
+	resource->pCachePrev = resource->pCacheNext = nullptr;
+
+	DWORD Bytes = resource->GetSize();
+	this->CacheBytes -= Bytes;
+	this->CacheStats[resource->Type].Cached --;
+	this->CacheStats[resource->Type].CachedBytes -= Bytes;
+}
+Resource * ResourceManager::CacheTrim()
+{
+	// Unlinks the least recently released until the cache fits its budget
+	Resource * pEvicted = nullptr;
+	while( this->CacheBytes > this->CacheBudget )
+	{
+		Resource * resource = this->pCacheTail;
+		this->CacheUnlink( resource );
+		this->CacheStats[resource->Type].Evictions ++;
+		resource->pCacheNext = pEvicted;
+		pEvicted = resource;
+	}
+
+	// The caller releases them once it has unlocked
+	return pEvicted;
+}
+void ResourceManager::SetCacheBudget(DWORD Bytes)
+{
+	this->Lock();
+	this->CacheBudget = Bytes;
+	Resource * pEvicted = this->CacheTrim();
+	this->Unlock();
+
+	while( pEvicted )
+	{
+		Resource * pNext = pEvicted->pCacheNext;
+		pEvicted->Release();
+		pEvicted = pNext;
+	}
+}
+Resource * ResourceManager::RestoreCached(ResourceID Type, LPSTR name, LPSTR Source)
+{
+	DWORD Hash = HashName( name );
+
+	this->Lock();
+
+	Resource * resource = this->pCacheHead;
+	while( resource && ( resource->Type != Type || resource->NameHash != Hash ||
+		resource->Source != Source || strcmp( name, resource->Name ) != 0 ) )
+		resource = resource->pCacheNext;
+	if( !resource )
+	{
+		this->CacheStats[Type].Misses ++;
+		this->Unlock();
+		return nullptr;
+	}
+
+	// The cache's reference goes back to the pool
+	this->CacheUnlink( resource );
+	if( FAILED( this->Insert( resource ) ) )
+	{
+		this->CacheStats[Type].Misses ++;
+		this->Unlock();
+		resource->Release();
+		return nullptr;
+	}
+	this->CacheStats[Type].Hits ++;
+	resource->Restores ++;
+	resource->AddRef();
+
+	this->Unlock();
+
+	return resource;
+}
+void ResourceManager::GetCacheStats(ResourceID Type, RESOURCE_CACHE_STATS * pOut)
+{
+	this->Lock();
+
+	*pOut = this->CacheStats[Type];
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_relaxed );
+	for( DWORD i = 0; pPool && i < pPool->Size; i++ )
+	{
+		Resource * resource = pPool->Slots[i].pResource.load( std::memory_order_relaxed );
+		if( resource && resource->Type == Type )
+		{
+			pOut->Resident ++;
+			pOut->ResidentBytes += resource->GetSize();
+		}
+	}
+
+	this->Unlock();
+}
+static const char * g_TypeNames[ResourceID_Count] =
+{
+	"Texture",
+	"Sprite",
+	"Sound",
+	"Mesh",
+	"Light",
+	"Other",
+};
+const char * ResourceManager::GetTypeName(ResourceID Type)
+{
+	return Type < ResourceID_Count ? g_TypeNames[Type] : "";
+}
+static int ReportAppend( char * pBuffer, DWORD Size, int Length, const char * szFormat, ... )
+{
+	// As snprintf, carries on counting once the buffer is full
+	bool Room = pBuffer && DWORD(Length) < Size;
+	va_list Args;
+	va_start( Args, szFormat );
+	int Written = vsnprintf( Room ? pBuffer + Length : nullptr, Room ? Size - Length : 0, szFormat, Args );
+	va_end( Args );
+	return Written > 0 ? Length + Written : Length;
+}
+int ResourceManager::Report(char * pBuffer, DWORD Size, RESOURCE_REPORT_ORDER Order)
+{
+	// Snapshot every resource under the lock, then sort and write without it
+	this->Lock();
+	DWORD Capacity = this->ResourceCount;
+	for( DWORD t = 0; t < ResourceID_Count; t++ )
+		Capacity += this->CacheStats[t].Cached;
+	RESOURCE_STATS * pStats = new(std::nothrow) RESOURCE_STATS[Capacity ? Capacity : 1];
+	if( !pStats )
+	{
+		this->Unlock();
+		return -1;
+	}
+	DWORD Count = 0;
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_relaxed );
+	for( DWORD i = 0; pPool && i < pPool->Size && Count < Capacity; i++ )
+	{
+		Resource * resource = pPool->Slots[i].pResource.load( std::memory_order_relaxed );
+		if( resource )
+			resource->GetStats( &pStats[Count++] );
+	}
+	for( Resource * resource = this->pCacheHead; resource && Count < Capacity; resource = resource->pCacheNext )
+	{
+		resource->GetStats( &pStats[Count] );
+		pStats[Count++].Cached = true;
+	}
+	this->Unlock();
+
+	switch( Order )
+	{
+	case RESOURCE_ORDER_Bytes:
+		std::sort( pStats, pStats + Count, [](const RESOURCE_STATS &a, const RESOURCE_STATS &b)
+			{ return a.CpuBytes + a.DeviceBytes > b.CpuBytes + b.DeviceBytes; } );
+		break;
+	case RESOURCE_ORDER_LoadTime:
+		std::sort( pStats, pStats + Count, [](const RESOURCE_STATS &a, const RESOURCE_STATS &b)
+			{ return a.LoadMilliseconds > b.LoadMilliseconds; } );
+		break;
+	case RESOURCE_ORDER_Lookups:
+		std::sort( pStats, pStats + Count, [](const RESOURCE_STATS &a, const RESOURCE_STATS &b)
+			{ return a.Lookups + a.Resolves > b.Lookups + b.Resolves; } );
+		break;
+	}
+
+	int Length = ReportAppend( pBuffer, Size, 0, "%-24s %-7s %-5s %5s %5s %10s %10s %9s %5s %8s %8s %8s\n",
+		"Resource", "Type", "State", "Refs", "Peak", "CPU (KB)", "Dev (KB)", "Load (ms)", "Loads", "Restores", "Lookups", "Resolves" );
+	RESOURCE_STATS Total;
+	memset( &Total, 0, sizeof(Total) );
+	for( DWORD i = 0; i < Count; i++ )
+	{
+		RESOURCE_STATS &Stats = pStats[i];
+		Length = ReportAppend( pBuffer, Size, Length, "%-24s %-7s %-5s %5u %5u %10.1f %10.1f %9.3f %5u %8u %8u %8u\n",
+			Stats.Name, GetTypeName( Stats.Type ), Stats.Cached ? "Cache" : "Pool",
+			Stats.RefCount, Stats.PeakRefCount,
+			Stats.CpuBytes/1024.0, Stats.DeviceBytes/1024.0, Stats.LoadMilliseconds,
+			Stats.Loads, Stats.Restores, Stats.Lookups, Stats.Resolves );
+		Total.CpuBytes += Stats.CpuBytes;
+		Total.DeviceBytes += Stats.DeviceBytes;
+		Total.LoadMilliseconds += Stats.LoadMilliseconds;
+		Total.Loads += Stats.Loads;
+		Total.Restores += Stats.Restores;
+		Total.Lookups += Stats.Lookups;
+		Total.Resolves += Stats.Resolves;
+	}
+	char szTotal[32];
+	snprintf( szTotal, 32, "Total (%u)", Count );
+	Length = ReportAppend( pBuffer, Size, Length, "%-24s %-7s %-5s %5s %5s %10.1f %10.1f %9.3f %5u %8u %8u %8u\n",
+		szTotal, "", "", "", "",
+		Total.CpuBytes/1024.0, Total.DeviceBytes/1024.0, Total.LoadMilliseconds,
+		Total.Loads, Total.Restores, Total.Lookups, Total.Resolves );
+
+	delete[] pStats;
+
+	return Length;
+}
+int ResourceManager::PoolGrow(DWORD NewSize)
+{
+	RESOURCE_POOL * pNewPool = new(std::nothrow) RESOURCE_POOL;
+	if( !pNewPool ) return E_OUTOFMEMORY;
+	pNewPool->Slots = new(std::nothrow) RESOURCE_SLOT[NewSize];
+	if( !pNewPool->Slots )
+	{
+		delete pNewPool;
+		return E_OUTOFMEMORY;
+	}
+	pNewPool->Size = NewSize;
+
+	RESOURCE_POOL * pOldPool = this->pPool.load( std::memory_order_relaxed );
+	pNewPool->pRetired = pOldPool;
+	DWORD OldSize = pOldPool ? pOldPool->Size : 0;
+	for( DWORD i = 0; i < NewSize; i++ )
+	{
+		RESOURCE_SLOT &Slot = pNewPool->Slots[i];
+		if( i < OldSize )
+		{
+			Slot.pResource.store( pOldPool->Slots[i].pResource.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+			Slot.Generation.store( pOldPool->Slots[i].Generation.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+		}
+		else
+		{
+			Slot.pResource.store( nullptr, std::memory_order_relaxed );
+			Slot.Generation.store( 1, std::memory_order_relaxed );
+		}
+	}
+	this->pPool.store( pNewPool, std::memory_order_release );
+
+	return S_OK;
+}
+int ResourceManager::PoolExpand(DWORD BySize)
+{
+	this->Lock();
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_relaxed );
+	int hr = this->PoolGrow( (pPool ? pPool->Size : 0) + BySize );
+	this->Unlock();
+
+	return hr;
+}
+int ResourceManager::PoolResize(DWORD NewSize)
+{
+	RESOURCE_POOL * pPool = this->pPool.load( std::memory_order_acquire );
+	int diff = NewSize - (pPool ? pPool->Size : 0);
+
+	if( diff > 0 )
+	{
+		PoolExpand( diff );
+	}
+
+	return S_OK;
+}
+
+
+
+void ResourceManager::LoaderThread(ResourceManager * pManager)
+{
+	TRACE_THREAD_NAME( "Loader" );
+
+	RESOURCE_LOADERS &Loaders = *pManager->pLoaders;
+	std::unique_lock<std::mutex> Lock( Loaders.Lock );
+	while( true )
+	{
+		Loaders.Queued.wait( Lock, [&Loaders]() { return Loaders.pQueued || Loaders.Stopping; } );
+		if( Loaders.Stopping )
+			break;
+		RESOURCE_LOAD * pLoad = PopLoad( Loaders.pQueued, Loaders.ppQueuedTail );
+		Lock.unlock();
+
+		pLoad->State.store( RESOURCE_LOAD_Decoding, std::memory_order_relaxed );
+		{
+			TRACE_SCOPE( "ResourceManager::Decode" );
+			unsigned long long Start = CTimer::Now();
+			pLoad->Result = pLoad->pLoader->pfnDecode( pLoad );
+			pLoad->DecodeCounts = CTimer::Now() - Start;
+		}
+
+		Lock.lock();
+		pLoad->State.store( RESOURCE_LOAD_Decoded, std::memory_order_relaxed );
+		AppendLoad( Loaders.ppDecodedTail, pLoad );
+		Loaders.Decoded.notify_all();
+	}
+}
+int ResourceManager::StartLoaders(DWORD Threads)
+{
+	if( !this->pLoaders ) return E_OUTOFMEMORY;
+	RESOURCE_LOADERS &Loaders = *this->pLoaders;
+	if( Loaders.ThreadCount ) return S_OK;
+
+	if( !Threads )
+	{
+		Threads = std::thread::hardware_concurrency();
+		Threads = Threads > 1 ? Threads - 1 : 1;
+	}
+	Loaders.Threads = new(std::nothrow) std::thread[Threads];
+	if( !Loaders.Threads ) return E_OUTOFMEMORY;
+
+	std::lock_guard<std::mutex> Lock( Loaders.Lock );
+	for( DWORD i = 0; i < Threads; i++ )
+		Loaders.Threads[i] = std::thread( LoaderThread, this );
+	Loaders.ThreadCount = Threads;
+
+	return S_OK;
+}
+void ResourceManager::StopLoaders()
+{
+	if( !this->pLoaders ) return;
+	RESOURCE_LOADERS &Loaders = *this->pLoaders;
+
+	{
+		std::lock_guard<std::mutex> Lock( Loaders.Lock );
+		Loaders.Stopping = true;
+	}
+	Loaders.Queued.notify_all();
+	for( DWORD i = 0; i < Loaders.ThreadCount; i++ )
+		Loaders.Threads[i].join();
+	delete[] Loaders.Threads;
+
+	// Whatever was not started is abandoned
+	std::lock_guard<std::mutex> Lock( Loaders.Lock );
+	Loaders.Threads = nullptr;
+	Loaders.ThreadCount = 0;
+	Loaders.Stopping = false;
+	while( RESOURCE_LOAD * pLoad = PopLoad( Loaders.pQueued, Loaders.ppQueuedTail ) )
+	{
+		pLoad->Result = E_ABORT;
+		pLoad->State.store( RESOURCE_LOAD_Decoded, std::memory_order_relaxed );
+		AppendLoad( Loaders.ppDecodedTail, pLoad );
+	}
+	Loaders.Decoded.notify_all();
+}
+RESOURCE_TICKET ResourceManager::LoadAsync(Resource * resource, LPSTR name, LPSTR Source, const RESOURCE_LOADER * pLoader)
+{
+	if( !this->pLoaders ) return nullptr;
+	RESOURCE_LOADERS &Loaders = *this->pLoaders;
+
+	RESOURCE_LOAD * pLoad = new(std::nothrow) RESOURCE_LOAD;
+	if( !pLoad ) return nullptr;
+	if( FAILED( this->AddResource( resource, name ) ) )
+	{
+		delete pLoad;
+		return nullptr;
+	}
+
+	resource->AddRef();
+	resource->Source = Source;
+	pLoad->pResource = resource;
+	pLoad->Source = Source;
+	pLoad->pLoader = pLoader;
+	pLoad->pDecoded = nullptr;
+	pLoad->Result = S_OK;
+	pLoad->DecodeCounts = 0;
+	pLoad->State.store( RESOURCE_LOAD_Queued, std::memory_order_relaxed );
+	pLoad->RefCount.store( 2, std::memory_order_relaxed );
+	Loaders.Pending.fetch_add( 1, std::memory_order_relaxed );
+
+	std::unique_lock<std::mutex> Lock( Loaders.Lock );
+	if( Loaders.ThreadCount )
+	{
+		AppendLoad( Loaders.ppQueuedTail, pLoad );
+		Lock.unlock();
+		Loaders.Queued.notify_one();
+	}
+	else
+	{
+		Lock.unlock();
+		unsigned long long Start = CTimer::Now();
+		pLoad->Result = pLoader->pfnDecode( pLoad );
+		pLoad->DecodeCounts = CTimer::Now() - Start;
+		Lock.lock();
+		pLoad->State.store( RESOURCE_LOAD_Decoded, std::memory_order_relaxed );
+		AppendLoad( Loaders.ppDecodedTail, pLoad );
+	}
+
+	return pLoad;
+}
+DWORD ResourceManager::UpdateLoads(DWORD MaxLoads)
+{
+	if( !this->pLoaders ) return 0;
+	RESOURCE_LOADERS &Loaders = *this->pLoaders;
+
+	DWORD Finished = 0;
+	while( Finished < MaxLoads )
+	{
+		RESOURCE_LOAD * pLoad;
+		{
+			std::lock_guard<std::mutex> Lock( Loaders.Lock );
+			pLoad = PopLoad( Loaders.pDecoded, Loaders.ppDecodedTail );
+		}
+		if( !pLoad ) break;
+
+		this->EndLoad( pLoad );
+		Finished ++;
+	}
+
+	return Finished;
+}
+void ResourceManager::EndLoad(RESOURCE_LOAD * pLoad)
+{
+	{
+		TRACE_SCOPE( "ResourceManager::Finish" );
+		unsigned long long Start = CTimer::Now();
+		pLoad->Result = pLoad->pLoader->pfnFinish( pLoad );
+		pLoad->pResource->LoadCounts += pLoad->DecodeCounts + ( CTimer::Now() - Start );
+		pLoad->pResource->Loads ++;
+	}
+	pLoad->State.store( RESOURCE_LOAD_Complete, std::memory_order_release );
+	this->pLoaders->Pending.fetch_sub( 1, std::memory_order_relaxed );
+	this->ReleaseLoad( pLoad );
+}
+bool ResourceManager::IsLoaded(RESOURCE_TICKET Ticket)
+{
+	return Ticket->State.load( std::memory_order_acquire ) == RESOURCE_LOAD_Complete;
+}
+HRESULT ResourceManager::WaitForLoad(RESOURCE_TICKET Ticket)
+{
+	RESOURCE_LOADERS &Loaders = *this->pLoaders;
+	while( !this->IsLoaded( Ticket ) )
+	{
+		// Finish what is ready; otherwise wait for a loader thread
+		if( !this->UpdateLoads( 1 ) )
+		{
+			std::unique_lock<std::mutex> Lock( Loaders.Lock );
+			Loaders.Decoded.wait( Lock, [&Loaders]() { return Loaders.pDecoded != nullptr; } );
+		}
+	}
+
+	return Ticket->Result;
+}
+void ResourceManager::ReleaseLoad(RESOURCE_TICKET Ticket)
+{
+	if( Ticket && Ticket->RefCount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+	{
+		Ticket->pResource->Release();
+		delete Ticket;
+	}
+}
+DWORD ResourceManager::GetPendingLoads()
+{
+	return this->pLoaders ? this->pLoaders->Pending.load( std::memory_order_relaxed ) : 0;
+}
+HRESULT ResourceManager::LoadNow(Resource * resource, LPSTR Source, const RESOURCE_LOADER * pLoader)
+{
+	RESOURCE_LOAD Load;
+	resource->Source = Source;
+	Load.pResource = resource;
+	Load.Source = Source;
+	Load.pLoader = pLoader;
+	Load.pDecoded = nullptr;
+
+	unsigned long long Start = CTimer::Now();
+	Load.Result = pLoader->pfnDecode( &Load );
+	HRESULT hr = pLoader->pfnFinish( &Load );
+	resource->LoadCounts += CTimer::Now() - Start;
+	resource->Loads ++;
+
+	return hr;
+}
+
+
+
+#ifdef MOWVE_IT_BENCHMARK
+/* Looks up random names in pools of 10, 1k and 100k
+resources three ways: by scanning the pool with strcmp (as
+GetResourceByName used to), through the hashed index, and
+by resolving handles. The time per lookup is written to the
+debugger output. The scans are cut short on large pools. */
+void BenchmarkResourceLookup()
+{
+	const DWORD Sizes[] = { 10, 1000, 100000 };
+	const DWORD Lookups = 100000;
+	char Name[32];
+
+	RESOURCE_HANDLE * Handles = new(std::nothrow) RESOURCE_HANDLE[Lookups];
+	char (* Names)[32] = new(std::nothrow) char[Lookups][32];
+	if( Handles && Names )
+	{
+		for( DWORD z = 0; z < sizeof(Sizes)/sizeof(Sizes[0]); z++ )
+		{
+			DWORD Count = Sizes[z];
+			ResourceManager * pManager = new(std::nothrow) ResourceManager();
+			if( !pManager ) break;
+			for( DWORD i = 0; i < Count; i++ )
+			{
+				Resource * pResource = new(std::nothrow) Resource();
+				if( !pResource ) break;
+				sprintf_s( Name, 32, "Resource%u", i );
+				pManager->AddResource( pResource, Name );
+				pResource->Release();
+			}
+
+			srand( 1 );
+			for( DWORD l = 0; l < Lookups; l++ )
+			{
+				DWORD Which = ( (DWORD(rand()) << 15) ^ DWORD(rand()) ) % Count;
+				sprintf_s( Names[l], 32, "Resource%u", Which );
+				Handles[l] = pManager->GetHandleByName( Names[l] );
+			}
+
+			// Keep the scans to about 10^8 comparisons
+			DWORD ScanLookups = Lookups;
+			if( UINT64(ScanLookups)*Count > 100000000 )
+				ScanLookups = DWORD( 100000000 / Count );
+
+			DWORD Found[3] = { 0, 0, 0 };
+			UINT64 Counts[3];
+			UINT64 Start = CTimer::Now();
+			for( DWORD l = 0; l < ScanLookups; l++ )
+			{
+				RESOURCE_POOL * pPool = pManager->pPool.load( std::memory_order_relaxed );
+				for( DWORD i = 0; i < pPool->Size; i++ )
+				{
+					Resource * pResource = pPool->Slots[i].pResource.load( std::memory_order_relaxed );
+					if( pResource && strcmp( Names[l], pResource->GetName() ) == 0 )
+					{
+						Found[0] ++;
+						break;
+					}
+				}
+			}
+			Counts[0] = CTimer::Now() - Start;
+
+			Start = CTimer::Now();
+			for( DWORD l = 0; l < Lookups; l++ )
+				if( pManager->FindByName( Names[l] ) != RESOURCE_INDEX_EMPTY )
+					Found[1] ++;
+			Counts[1] = CTimer::Now() - Start;
+
+			Start = CTimer::Now();
+			for( DWORD l = 0; l < Lookups; l++ )
+				if( pManager->Resolve( Handles[l] ) )
+					Found[2] ++;
+			Counts[2] = CTimer::Now() - Start;
+
+			double Scale = 1e9 / double( CTimer::Frequency() );
+			char str[256];
+			sprintf_s( str, 256, "Resource lookup, %6u resources: scan %.1f ns, hashed %.1f ns, handle %.1f ns (found %u/%u, %u/%u, %u/%u).\n",
+				Count,
+				double(Counts[0])*Scale / double(ScanLookups),
+				double(Counts[1])*Scale / double(Lookups),
+				double(Counts[2])*Scale / double(Lookups),
+				Found[0], ScanLookups, Found[1], Lookups, Found[2], Lookups );
+			OutputDebugStringA( str );
+
+			delete pManager;
+		}
+	}
+	delete[] Handles;
+	delete[] Names;
+}
+#endif
+
+
+
+Resource::Resource()
+{
+	this->RefCount = 1;
+	this->Name = nullptr;
+	this->NameHash = 0;
+	this->Type = ResourceID_Other;
+	this->CpuBytes = 0;
+	this->DeviceBytes = 0;
+	this->Source = nullptr;
+	this->pCachePrev = nullptr;
+	this->pCacheNext = nullptr;
+	this->LoadCounts = 0;
+	this->Loads = 0;
+	this->Restores = 0;
+	this->Lookups.store( 0, std::memory_order_relaxed );
+	this->Resolves.store( 0, std::memory_order_relaxed );
+	this->PeakRefCount.store( 1, std::memory_order_relaxed );
+}
+Resource::~Resource()
+{
+}
+int Resource::AddRef()
+{
+	DWORD NewRefCount = this->RefCount.fetch_add( 1, std::memory_order_relaxed ) + 1;
+	DWORD Peak = this->PeakRefCount.load( std::memory_order_relaxed );
+	while( NewRefCount > Peak &&
+		!this->PeakRefCount.compare_exchange_weak( Peak, NewRefCount, std::memory_order_relaxed ) );
+	return NewRefCount;
+}
+int Resource::Release()
+{
+	// Whoever drops the last reference sees every write made through the others
+	DWORD NewRefCount = this->RefCount.fetch_sub( 1, std::memory_order_acq_rel ) - 1;
+	if( NewRefCount == 0 )
+	{
+		delete[] this->Name;
+		delete this;
+	}
+	return NewRefCount;
+}
+LPSTR Resource::GetName()
+{
+	return this->Name;
+}
+ResourceID Resource::GetType()
+{
+	return this->Type;
+}
+DWORD Resource::GetSize()
+{
+	return this->CpuBytes + this->DeviceBytes;
+}
+void Resource::SetSize(DWORD CpuBytes, DWORD DeviceBytes)
+{
+	this->CpuBytes = CpuBytes;
+	this->DeviceBytes = DeviceBytes;
+}
+void Resource::GetStats(RESOURCE_STATS * pOut)
+{
+	pOut->Name[0] = 0;
+	if( this->Name )
+	{
+		strncpy( pOut->Name, this->Name, sizeof(pOut->Name) - 1 );
+		pOut->Name[sizeof(pOut->Name) - 1] = 0;
+	}
+	pOut->Type = this->Type;
+	pOut->RefCount = this->RefCount.load( std::memory_order_relaxed );
+	pOut->PeakRefCount = this->PeakRefCount.load( std::memory_order_relaxed );
+	pOut->CpuBytes = this->CpuBytes;
+	pOut->DeviceBytes = this->DeviceBytes;
+	pOut->LoadMilliseconds = double( this->LoadCounts ) * 1000.0 / double( CTimer::Frequency() );
+	pOut->Loads = this->Loads;
+	pOut->Restores = this->Restores;
+	pOut->Lookups = this->Lookups.load( std::memory_order_relaxed );
+	pOut->Resolves = this->Resolves.load( std::memory_order_relaxed );
+	pOut->Cached = false;
+}
+
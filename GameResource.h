@@ -1,140 +1,455 @@
-
-#pragma once
-
-#ifndef DIRECTSOUND_VERSION
-#define DIRECTSOUND_VERSION 0x1000
-#endif
-#include <new>
-#include <d3dx9.h>
-#include <dsound.h>
-
-
-
-enum ResourceID
-{
-	ResourceID_Texture,
-	ResourceID_Sprite,
-	ResourceID_Sound,
-	ResourceID_Mesh,
-};
-
-
-
-/* Resource class.
-This is a base structure from which
-resources can derive, inheriting
-these basic properties. */
-class Resource
-{
-public:
-	friend class ResourceManager;
-	/* Methods */
-	Resource();
-	virtual ~Resource();
-
-	int			AddRef();
-	int			Release();
-	LPSTR		GetName();
-
-protected:
-	/* Properties */
-	DWORD RefCount;
-	LPSTR Name;
-};
-
-/* Resource manager */
-class ResourceManager
-{
-public:
-	/* Constructors and destructors */
-	ResourceManager();
-	~ResourceManager();
-
-	/* Methods */
-	int AddResource(
-		Resource * pIn,
-		LPSTR name);
-		/* Unconditionally adds
-		resource to reference list */
-
-	int ReleaseResource(
-		Resource * pIn);
-		/* Removes resource from reference list,
-		assuming the is referenced. */
-
-	Resource * GetResourceByName(
-		LPSTR name);
-		/* Returns pointer to a resource whose
-		name matches one of those referenced in
-		the reference list. */
-
-
-	int PoolExpand(
-		DWORD BySize);
-		/* Expands size of reference list pool
-		by variable amount. */
-
-	int PoolResize(
-		DWORD NewSize);
-		/* Resizes size of reference list pool
-		to an absolute size. This function will
-		not attempt to shrink the reference list. */
-	
-private:
-	/* Data */
-	HANDLE hAccessMutex;
-	Resource ** Pool;
-	DWORD PoolSize;
-};
-
-
-
-class Resource_Sound : public Resource
-{
-public:
-	Resource_Sound();
-	~Resource_Sound();
-
-	IDirectSoundBuffer * pBuffer;
-};
-class Resource_Texture : public Resource
-{
-public:
-	Resource_Texture();
-	~Resource_Texture();
-
-	IDirect3DTexture9 * pTexture;
-};
-class Resource_Sprite : public Resource
-{
-public:
-	Resource_Sprite();
-	~Resource_Sprite();
-
-	void GetRect(LPRECT);
-	void Update();
-
-	IDirect3DTexture9 * pTexture;
-	IDirect3DSurface9 * pSurface;
-	float fImageSpeed;
-	float fImageIndex;
-	DWORD dwSpriteWidth;
-};
-class Resource_Mesh : public Resource
-{
-public:
-	Resource_Mesh();
-	~Resource_Mesh();
-	int Draw();
-
-	D3DXMESHCONTAINER * pMesh;
-	Resource_Texture ** ppTextures;
-};
-class Resource_Light : public Resource
-{
-public:
-	Resource_Light();
-
-	D3DLIGHT9 Light;
-};
-
+
+#pragma once
+
+#ifndef DIRECTSOUND_VERSION
+#define DIRECTSOUND_VERSION 0x1000
+#endif
+#include <new>
+#include <atomic>
+#include <d3dx9.h>
+#include <dsound.h>
+
+
+
+enum ResourceID
+{
+	ResourceID_Texture,
+	ResourceID_Sprite,
+	ResourceID_Sound,
+	ResourceID_Mesh,
+	ResourceID_Light,
+	ResourceID_Other,
+	// Number of types
+	ResourceID_Count,
+};
+
+
+
+/* RESOURCE_HANDLE refers to a resource by its place in
+the pool of a ResourceManager. Look a resource up by name
+once, keep the handle and resolve it when it is needed;
+resolving never hashes or compares strings. Once the
+resource is released from the pool, the generation of its
+place changes and the handle resolves to nothing. A handle
+whose generation is zero refers to nothing. */
+struct RESOURCE_HANDLE
+{
+	DWORD Index;
+	DWORD Generation;
+};
+
+
+
+/* A snapshot of the life of one resource so far. Load time
+counts the decode and finish steps, not the time spent
+queued. Misses of the cache have no resource to count
+against; each one shows up as a load instead. */
+struct RESOURCE_STATS
+{
+	char Name[32]; // Cut short if longer
+	ResourceID Type;
+	DWORD RefCount;
+	DWORD PeakRefCount;
+	DWORD CpuBytes;
+	DWORD DeviceBytes;
+	double LoadMilliseconds;
+	DWORD Loads;
+	DWORD Restores; // From the cache
+	DWORD Lookups; // By name
+	DWORD Resolves; // By handle
+	bool Cached;
+};
+enum RESOURCE_REPORT_ORDER
+{
+	RESOURCE_ORDER_Bytes, // CPU and device bytes together
+	RESOURCE_ORDER_LoadTime,
+	RESOURCE_ORDER_Lookups, // By name and by handle together
+};
+
+
+
+/* Resource class.
+This is a base structure from which
+resources can derive, inheriting
+these basic properties. The reference
+count is atomic, so references may be
+taken and dropped on any thread. */
+class Resource
+{
+public:
+	friend class ResourceManager;
+	/* Methods */
+	Resource();
+	virtual ~Resource();
+
+	int			AddRef();
+	int			Release();
+	LPSTR		GetName();
+	ResourceID	GetType();
+	DWORD		GetSize(); // CPU and device bytes together
+	void		SetSize(DWORD CpuBytes, DWORD DeviceBytes);
+	void		GetStats(RESOURCE_STATS * pOut);
+
+protected:
+	/* Properties */
+	std::atomic<DWORD> RefCount;
+	LPSTR Name;
+	DWORD NameHash; // Set by ResourceManager::AddResource
+	ResourceID Type; // Set by the constructor of each kind
+	DWORD CpuBytes; // Held once loaded, or 0 if not known
+	DWORD DeviceBytes;
+	LPSTR Source; // It was loaded from, as given to LoadAsync or LoadNow
+	Resource * pCachePrev; // Towards the most recently cached
+	Resource * pCacheNext;
+
+	/* Statistics, see RESOURCE_STATS. The counters of
+	lookups are atomic, as lookups are made from any thread. */
+	unsigned long long LoadCounts; // CTimer counts
+	DWORD Loads;
+	DWORD Restores;
+	std::atomic<DWORD> Lookups;
+	std::atomic<DWORD> Resolves;
+	std::atomic<DWORD> PeakRefCount;
+};
+
+/* Resource manager.
+Names are interned: AddResource copies the name into the
+resource and hashes it once, and an open-addressing index
+(linear probing, at most half full) maps the hash to the
+place in the pool, so GetResourceByName compares strings
+only on a hash match. Places freed by ReleaseResource are
+reused before the pool grows.
+The manager may be used from any thread. Lookups take no
+lock: every place and index entry is written with a
+release store after what it points to is complete, and
+when the pool or index grows it is replaced by a larger
+copy, while the one it replaced is kept (see pRetired)
+until the manager is destroyed, so a lookup still reading
+it stays safe. Adding and releasing resources take an
+exclusive lock, which counts how often it had to wait
+(see GetLockStats). A lookup that races with an add may
+miss the new resource; one that races with the release of
+the same resource may return it, so a resource must only
+be released from the pool once no other thread uses it.
+With a cache budget set, ReleaseResource hands the pool's
+reference to a cache instead of dropping it, as long as
+the size of the resource is known. Cached resources are
+out of the pool (lookups do not find them) but still
+loaded, in a list ordered by when they were released, and
+RestoreCached takes them back. The cache is guarded by the
+same lock as the pool. */
+struct RESOURCE_SLOT
+{
+	std::atomic<Resource *> pResource;
+	std::atomic<DWORD> Generation;
+};
+struct RESOURCE_POOL
+{
+	DWORD Size;
+	RESOURCE_SLOT * Slots;
+	RESOURCE_POOL * pRetired; // The smaller pool this replaced
+};
+struct RESOURCE_INDEX_ENTRY
+{
+	DWORD Hash; // Written before Index
+	std::atomic<DWORD> Index; // Place in the pool, or one of the values below
+};
+#define RESOURCE_INDEX_EMPTY	0xFFFFFFFF
+#define RESOURCE_INDEX_REMOVED	0xFFFFFFFE
+struct RESOURCE_INDEX
+{
+	DWORD Capacity; // Power of two
+	RESOURCE_INDEX_ENTRY * Entries;
+	RESOURCE_INDEX * pRetired; // The index this replaced
+};
+/* Asynchronous loading.
+LoadAsync adds a resource to the pool at once, so that it
+is found by name and never loaded twice, and queues it for
+the loader threads. A loader thread runs the loader's decode
+step, which reads and parses the source, into system memory
+only. The finish step then runs on the main thread, from
+UpdateLoads, to create the device objects (if the decode
+step succeeded) and to free whatever the decode step left.
+Until then the resource is in the pool but empty, so users
+of a resource that may still be loading must allow for that.
+LoadAsync returns a ticket, which keeps the load until it is
+given to ReleaseLoad; it may be polled with IsLoaded, or
+waited on with WaitForLoad. Without loader threads, the
+decode step runs in LoadAsync itself. */
+enum RESOURCE_LOAD_STATE
+{
+	RESOURCE_LOAD_Queued,
+	RESOURCE_LOAD_Decoding,
+	RESOURCE_LOAD_Decoded, // Waiting for UpdateLoads
+	RESOURCE_LOAD_Complete,
+};
+struct RESOURCE_LOAD;
+struct RESOURCE_LOADER
+{
+	HRESULT (*pfnDecode)(RESOURCE_LOAD *); // On a loader thread
+	HRESULT (*pfnFinish)(RESOURCE_LOAD *); // On the main thread, however decoding went
+};
+struct RESOURCE_LOAD
+{
+	Resource * pResource; // Referenced until the load is released
+	LPSTR Source; // For the loader, such as the ID of an embedded resource
+	const RESOURCE_LOADER * pLoader;
+	void * pDecoded; // Left by the decode step for the finish step
+	HRESULT Result; // Of the decode step, then of the finish step
+	unsigned long long DecodeCounts; // CTimer counts the decode step took
+	std::atomic<DWORD> State; // See RESOURCE_LOAD_STATE
+	std::atomic<DWORD> RefCount; // The manager's until complete, and the ticket's
+	RESOURCE_LOAD * pNext; // In the queue it is on
+};
+typedef RESOURCE_LOAD * RESOURCE_TICKET;
+struct RESOURCE_LOADERS; // Threads and queues, see GameResource.cpp
+
+/* Memory held by the resources of one type, and how the
+cache has done for them. */
+struct RESOURCE_CACHE_STATS
+{
+	DWORD Resident; // In the pool
+	DWORD ResidentBytes;
+	DWORD Cached; // Released, but kept for RestoreCached
+	DWORD CachedBytes;
+	DWORD Hits;
+	DWORD Misses;
+	DWORD Evictions;
+};
+
+/* Use of the lock which guards changes to the pool. */
+struct RESOURCE_LOCK_STATS
+{
+	DWORD Acquires;
+	DWORD Contended; // Acquires which had to wait
+	double WaitMilliseconds; // Spent waiting, in all
+};
+class ResourceManager
+{
+public:
+	/* Constructors and destructors */
+	ResourceManager();
+	~ResourceManager();
+
+	/* Methods */
+	int AddResource(
+		Resource * pIn,
+		LPSTR name);
+		/* Unconditionally adds
+		resource to reference list */
+
+	int ReleaseResource(
+		Resource * pIn);
+		/* Removes resource from reference list,
+		assuming the is referenced. */
+
+	Resource * GetResourceByName(
+		LPSTR name);
+		/* Returns pointer to a resource whose
+		name matches one of those referenced in
+		the reference list. */
+
+	RESOURCE_HANDLE GetHandleByName(
+		LPSTR name);
+		/* As GetResourceByName, but returns a
+		handle to keep in place of the name. */
+
+	Resource * Resolve(
+		RESOURCE_HANDLE hResource);
+		/* Returns the resource a handle refers
+		to, or nullptr once it has been released. */
+
+	static DWORD HashName(
+		LPCSTR name);
+
+
+	int PoolExpand(
+		DWORD BySize);
+		/* Expands size of reference list pool
+		by variable amount. */
+
+	int PoolResize(
+		DWORD NewSize);
+		/* Resizes size of reference list pool
+		to an absolute size. This function will
+		not attempt to shrink the reference list. */
+
+	void GetLockStats(
+		RESOURCE_LOCK_STATS * pOut);
+
+	void SetCacheBudget(
+		DWORD Bytes);
+		/* Keeps resources given to ReleaseResource
+		resident, up to this many bytes in all, so
+		that RestoreCached can bring them back;
+		beyond that, the least recently released
+		are freed. Zero turns the cache off, which
+		is the default. */
+
+	Resource * RestoreCached(
+		ResourceID Type,
+		LPSTR name,
+		LPSTR Source);
+		/* Puts the cached resource of this type,
+		name and source back in the pool, and
+		returns it with a reference for the caller,
+		or returns nullptr if none is cached.
+		Sources are compared by value, as the IDs
+		of embedded resources are. */
+
+	void GetCacheStats(
+		ResourceID Type,
+		RESOURCE_CACHE_STATS * pOut);
+
+	int Report(
+		char * pBuffer,
+		DWORD Size,
+		RESOURCE_REPORT_ORDER Order);
+		/* Writes a table of the statistics of every
+		resource in the pool or the cache, sorted by
+		the given order (largest first), then the
+		totals. Returns the length of the whole table
+		even if the buffer is too small for it, as
+		snprintf does, or -1 if there was not the
+		memory for a snapshot. */
+
+	static const char * GetTypeName(
+		ResourceID Type);
+
+	int StartLoaders(
+		DWORD Threads);
+		/* Starts the loader threads; with zero,
+		one fewer than there are processors, but
+		at least one. */
+
+	void StopLoaders();
+		/* Stops the loader threads once each has
+		finished the load it is on. Loads still
+		queued fail with E_ABORT, and are finished
+		by the next UpdateLoads. */
+
+	RESOURCE_TICKET LoadAsync(
+		Resource * pIn,
+		LPSTR name,
+		LPSTR Source,
+		const RESOURCE_LOADER * pLoader);
+		/* Adds resource to reference list and
+		queues it to be loaded. Returns nullptr
+		if it could not be added. */
+
+	DWORD UpdateLoads(
+		DWORD MaxLoads);
+		/* Runs the finish step of up to MaxLoads
+		decoded loads. Main thread only. */
+
+	bool IsLoaded(
+		RESOURCE_TICKET Ticket);
+
+	HRESULT WaitForLoad(
+		RESOURCE_TICKET Ticket);
+		/* Finishes loads until this one is done,
+		and returns how it went. Main thread only. */
+
+	void ReleaseLoad(
+		RESOURCE_TICKET Ticket);
+
+	DWORD GetPendingLoads();
+
+	static HRESULT LoadNow(
+		Resource * pIn,
+		LPSTR Source,
+		const RESOURCE_LOADER * pLoader);
+		/* Runs both steps of a loader on this
+		thread, for synchronous loads. */
+	
+private:
+	static void LoaderThread(ResourceManager *);
+	void EndLoad(RESOURCE_LOAD *);
+
+	void Lock();
+	void Unlock();
+	int PoolGrow(DWORD NewSize);
+	int Insert(Resource *);
+	void CacheUnlink(Resource *);
+	Resource * CacheTrim();
+	int IndexInsert(DWORD Hash, DWORD Index);
+	int IndexRebuild(DWORD NewCapacity);
+	DWORD FindByName(LPSTR name);
+
+#ifdef MOWVE_IT_BENCHMARK
+	friend void BenchmarkResourceLookup();
+#endif
+
+	/* Data */
+	SRWLOCK AccessLock; // Held by AddResource, ReleaseResource and PoolExpand
+	std::atomic<RESOURCE_POOL *> pPool;
+	std::atomic<RESOURCE_INDEX *> pIndex;
+	DWORD ResourceCount; // Places in use
+	DWORD FreeHint; // No place below this is free
+	DWORD IndexUsed; // Entries that are not empty, counting removed ones
+	std::atomic<DWORD> LockAcquires;
+	std::atomic<DWORD> LockContended;
+	std::atomic<unsigned long long> LockWaitCounts;
+	RESOURCE_LOADERS * pLoaders;
+	DWORD CacheBudget; // Bytes, or 0
+	DWORD CacheBytes; // Held by cached resources
+	Resource * pCacheHead; // Most recently released
+	Resource * pCacheTail; // Next to be evicted
+	RESOURCE_CACHE_STATS CacheStats[ResourceID_Count]; // Resident counts are left at 0
+};
+
+#ifdef MOWVE_IT_BENCHMARK
+void BenchmarkResourceLookup();
+#endif
+
+
+
+class Resource_Sound : public Resource
+{
+public:
+	Resource_Sound();
+	~Resource_Sound();
+
+	IDirectSoundBuffer * pBuffer;
+};
+class Resource_Texture : public Resource
+{
+public:
+	Resource_Texture();
+	~Resource_Texture();
+
+	IDirect3DTexture9 * pTexture;
+};
+class Resource_Sprite : public Resource
+{
+public:
+	Resource_Sprite();
+	~Resource_Sprite();
+
+	void GetRect(LPRECT);
+	void Update();
+
+	IDirect3DTexture9 * pTexture;
+	IDirect3DSurface9 * pSurface;
+	float fImageSpeed;
+	float fImageIndex;
+	DWORD dwSpriteWidth;
+};
+class Resource_Mesh : public Resource
+{
+public:
+	Resource_Mesh();
+	~Resource_Mesh();
+	int Draw();
+
+	D3DXMESHCONTAINER * pMesh;
+	Resource_Texture ** ppTextures;
+};
+class Resource_Light : public Resource
+{
+public:
+	Resource_Light();
+
+	D3DLIGHT9 Light;
+};
+
@@ -0,0 +1,197 @@
+#include "Profile.h"
+#include "FramePacer.h"
+#include <stdio.h>
+#include <new>
+#include <algorithm>
+
+#ifdef MOWVE_IT_TRACE
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+
+
+static const char * g_PhaseNames[PROFILE_PhaseCount] =
+{
+	"Queue",
+	"Camera",
+	"Mouse",
+	"Keyboard",
+	"Update",
+	"Render",
+	"Present",
+};
+
+
+
+CFrameProfiler::CFrameProfiler()
+{
+	for( unsigned int p = 0; p < PROFILE_PhaseCount; p++ )
+	{
+		this->Start[p] = 0;
+		this->Written[p].store( 0, std::memory_order_relaxed );
+	}
+	this->CountsToMilliseconds = 1000.0 / double( CTimer::Frequency() );
+}
+void CFrameProfiler::Begin(PROFILE_PHASE Phase)
+{
+	this->Start[Phase] = CTimer::Now();
+}
+void CFrameProfiler::End(PROFILE_PHASE Phase)
+{
+	this->AddSample( Phase, float( double( CTimer::Now() - this->Start[Phase] ) * this->CountsToMilliseconds ) );
+}
+void CFrameProfiler::AddSample(PROFILE_PHASE Phase, float Milliseconds)
+{
+	unsigned int n = this->Written[Phase].load( std::memory_order_relaxed );
+	this->Ring[Phase][n % PROFILE_WINDOW] = Milliseconds;
+	this->Written[Phase].store( n + 1, std::memory_order_release );
+}
+bool CFrameProfiler::GetStats(PROFILE_PHASE Phase, PROFILE_STATS * pOut)
+{
+	unsigned int n = this->Written[Phase].load( std::memory_order_acquire );
+	if( n > PROFILE_WINDOW ) n = PROFILE_WINDOW;
+
+	pOut->Samples = n;
+	pOut->P50 = pOut->P95 = pOut->P99 = pOut->Max = 0.0;
+	if( !n ) return false;
+
+	// Percentiles by nearest rank over a sorted copy of the window
+	float Sorted[PROFILE_WINDOW];
+	for( unsigned int i = 0; i < n; i++ )
+		Sorted[i] = this->Ring[Phase][i];
+	std::sort( Sorted, Sorted + n );
+
+	pOut->P50 = Sorted[ (n*50 + 99)/100 - 1 ];
+	pOut->P95 = Sorted[ (n*95 + 99)/100 - 1 ];
+	pOut->P99 = Sorted[ (n*99 + 99)/100 - 1 ];
+	pOut->Max = Sorted[ n - 1 ];
+
+	return true;
+}
+int CFrameProfiler::Dump(char * pBuffer, unsigned int Size)
+{
+	int Length = snprintf( pBuffer, Size, "%-10s %7s %9s %9s %9s %9s\n",
+		"Phase", "Samples", "p50 (ms)", "p95 (ms)", "p99 (ms)", "max (ms)" );
+	for( unsigned int p = 0; p < PROFILE_PhaseCount && Length >= 0 && unsigned(Length) < Size; p++ )
+	{
+		PROFILE_STATS Stats;
+		this->GetStats( PROFILE_PHASE(p), &Stats );
+		Length += snprintf( pBuffer + Length, Size - Length, "%-10s %7u %9.3f %9.3f %9.3f %9.3f\n",
+			g_PhaseNames[p], Stats.Samples, Stats.P50, Stats.P95, Stats.P99, Stats.Max );
+	}
+
+	return Length;
+}
+const char * CFrameProfiler::GetPhaseName(PROFILE_PHASE Phase)
+{
+	return Phase < PROFILE_PhaseCount ? g_PhaseNames[Phase] : "";
+}
+
+
+
+#ifdef MOWVE_IT_TRACE
+struct TRACE_EVENT
+{
+	const char * Name;
+	unsigned int Thread;
+	bool Metadata; // Names the thread rather than timing a scope
+	unsigned long long Start;
+	unsigned long long End;
+};
+
+static TRACE_EVENT * g_pTraceEvents = nullptr;
+static unsigned int g_TraceCapacity = 0;
+static std::atomic<unsigned int> g_TraceCount( 0 );
+static unsigned long long g_TraceOrigin = 0;
+
+static unsigned int TraceThreadId()
+{
+#ifdef _WIN32
+	return (unsigned int)GetCurrentThreadId();
+#else
+	return (unsigned int)syscall( SYS_gettid );
+#endif
+}
+static void TraceAdd(const char * Name, bool Metadata, unsigned long long Start, unsigned long long End)
+{
+	unsigned int i = g_TraceCount.fetch_add( 1, std::memory_order_relaxed );
+	if( i >= g_TraceCapacity ) return;
+
+	TRACE_EVENT &Event = g_pTraceEvents[i];
+	Event.Name = Name;
+	Event.Thread = TraceThreadId();
+	Event.Metadata = Metadata;
+	Event.Start = Start;
+	Event.End = End;
+}
+
+bool TraceStart(unsigned int Capacity)
+{
+	g_pTraceEvents = new(std::nothrow) TRACE_EVENT[Capacity];
+	if( !g_pTraceEvents ) return false;
+
+	g_TraceCapacity = Capacity;
+	g_TraceCount.store( 0, std::memory_order_relaxed );
+	g_TraceOrigin = CTimer::Now();
+
+	return true;
+}
+bool TraceStop(const char * szFileName)
+{
+	if( !g_pTraceEvents ) return false;
+
+	unsigned int Count = g_TraceCount.load( std::memory_order_acquire );
+	unsigned int Dropped = 0;
+	if( Count > g_TraceCapacity )
+	{
+		Dropped = Count - g_TraceCapacity;
+		Count = g_TraceCapacity;
+	}
+	g_TraceCapacity = 0;
+
+	FILE * pFile = fopen( szFileName, "w" );
+	if( pFile )
+	{
+		// Timestamps are in microseconds from TraceStart
+		double Scale = 1000000.0 / double( CTimer::Frequency() );
+		fprintf( pFile, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%u},\"traceEvents\":[", Dropped );
+		for( unsigned int i = 0; i < Count; i++ )
+		{
+			TRACE_EVENT &Event = g_pTraceEvents[i];
+			if( Event.Metadata )
+				fprintf( pFile, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+					i ? "," : "", Event.Thread, Event.Name );
+			else
+				fprintf( pFile, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					i ? "," : "", Event.Name, Event.Thread,
+					double( Event.Start - g_TraceOrigin )*Scale, double( Event.End - Event.Start )*Scale );
+		}
+		fprintf( pFile, "\n]}\n" );
+		fclose( pFile );
+	}
+
+	delete[] g_pTraceEvents;
+	g_pTraceEvents = nullptr;
+
+	return pFile != nullptr;
+}
+void TraceThreadName(const char * Name)
+{
+	TraceAdd( Name, true, 0, 0 );
+}
+
+CTraceScope::CTraceScope(const char * Name)
+{
+	this->Name = Name;
+	this->Start = CTimer::Now();
+}
+CTraceScope::~CTraceScope()
+{
+	TraceAdd( this->Name, false, this->Start, CTimer::Now() );
+}
+#endif
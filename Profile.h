@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+
+
+
+/* The stages of the main loop which are timed. */
+enum PROFILE_PHASE
+{
+	PROFILE_Queue, // g_Queue.Execute, which includes level loads, and UpdateLoads
+	PROFILE_Camera,
+	PROFILE_Mouse,
+	PROFILE_Keyboard,
+	PROFILE_Update, // One tick of the context, with its kills
+	PROFILE_Render, // BeginScene to EndScene
+	PROFILE_Present,
+	// Number of phases
+	PROFILE_PhaseCount,
+};
+
+/* Statistics over the samples of one phase, in milliseconds. */
+struct PROFILE_STATS
+{
+	unsigned int Samples; // Samples in the window
+	double P50;
+	double P95;
+	double P99;
+	double Max;
+};
+
+
+
+/* CFrameProfiler keeps the most recent PROFILE_WINDOW durations
+of each phase in a ring buffer. Only the main loop writes
+samples; each write stores the sample and then publishes it by
+advancing the count, so GetStats can be called from any thread
+without a lock. A reader that races with the writer lapping the
+ring may see one sample of the next frame, which is harmless for
+statistics. Phases which run several times a frame (such as the
+ticks of Update) record one sample per run. */
+#define PROFILE_WINDOW 512
+class CFrameProfiler
+{
+public:
+	CFrameProfiler();
+
+	void Begin(PROFILE_PHASE Phase);
+	void End(PROFILE_PHASE Phase);
+	void AddSample(PROFILE_PHASE Phase, float Milliseconds);
+
+	bool GetStats(PROFILE_PHASE Phase, PROFILE_STATS * pOut);
+	int Dump(char * pBuffer, unsigned int Size); // Table of every phase
+
+	static const char * GetPhaseName(PROFILE_PHASE Phase);
+
+private:
+	unsigned long long Start[PROFILE_PhaseCount];
+	float Ring[PROFILE_PhaseCount][PROFILE_WINDOW];
+	std::atomic<unsigned int> Written[PROFILE_PhaseCount];
+	double CountsToMilliseconds;
+};
+
+
+
+/* Scoped timing markers for the Chrome trace viewer (or
+Perfetto). They are only compiled in when MOWVE_IT_TRACE is
+defined in the project settings; otherwise TRACE_SCOPE and
+TRACE_THREAD_NAME expand to nothing.
+TRACE_SCOPE records one complete event from where it appears
+to the end of the enclosing block. Names must be string
+literals, as only the pointer is kept. Events from every
+thread go into one buffer, claimed with an atomic increment;
+once TraceStart's capacity is used up, further events are
+counted and dropped. TraceStop writes the buffer as JSON,
+one track per thread, so it must only be called once other
+threads have stopped tracing. */
+#ifdef MOWVE_IT_TRACE
+bool TraceStart(unsigned int Capacity);
+bool TraceStop(const char * szFileName);
+void TraceThreadName(const char * Name);
+
+class CTraceScope
+{
+public:
+	CTraceScope(const char * Name);
+	~CTraceScope();
+
+private:
+	const char * Name;
+	unsigned long long Start;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(Name) CTraceScope TRACE_CONCAT(_TraceScope, __LINE__)( Name )
+#define TRACE_THREAD_NAME(Name) TraceThreadName( Name )
+#else
+#define TRACE_SCOPE(Name)
+#define TRACE_THREAD_NAME(Name)
+#endif
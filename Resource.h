@@ -1,58 +1,58 @@
-
-
-#ifndef IDC_STATIC
-#define IDC_STATIC (-1)
-#endif
-
-#define IDR_RSRC_GR1			101
-#define IDR_RSRC_GR2			102
-#define IDR_RSRC_GR3			103
-#define IDR_RSRC_GNM			104
-#define IDR_RSRC_MIN			105
-#define IDR_RSRC_MOV			106
-#define IDR_RSRC_MNT			107
-#define IDR_RSRC_MSO			108
-#define IDR_RSRC_MTR			109
-#define IDR_RSRC_MTB			110
-#define IDR_RSRC_MCT			111
-#define IDR_RSRC_MDG			112
-#define IDR_RSRC_MRB			113
-#define IDR_RSRC_MHL			114
-#define IDR_RSRC_BNI			115
-#define IDR_RSRC_BNA			116
-#define IDR_RSRC_BNP			117
-#define IDR_RSRC_BND			118
-#define IDR_RSRC_TGB			119
-#define IDR_RSRC_TSG			120
-#define IDR_RSRC_TDT			121
-#define IDR_RSRC_TSP			122
-#define IDR_RSRC_SGL			123
-#define IDR_RSRC_SDC			124
-#define IDR_RSRC_SDH			125
-
-#define IDR_STR_Grass1			IDR_RSRC_GR1
-#define IDR_STR_Grass2			IDR_RSRC_GR2
-#define IDR_STR_Grass3			IDR_RSRC_GR3
-#define IDR_STR_Gnome			IDR_RSRC_GNM
-#define IDR_STR_MowerMini		IDR_RSRC_MIN
-#define IDR_STR_MowerMover		IDR_RSRC_MOV
-#define IDR_STR_MowerMonster	IDR_RSRC_MNT
-#define IDR_STR_Ornament		IDR_RSRC_MSO
-#define IDR_STR_Tree			IDR_RSRC_MTR
-#define IDR_STR_TreeBeehive		IDR_RSRC_MTB
-#define IDR_STR_Cat				IDR_RSRC_MCT
-#define IDR_STR_Dog				IDR_RSRC_MDG
-#define IDR_STR_RabbitHelper	IDR_RSRC_MRB
-#define IDR_STR_MoleHill		IDR_RSRC_MHL
-#define IDR_STR_ButtonInactive	IDR_RSRC_BNI
-#define IDR_STR_ButtonActive	IDR_RSRC_BNA
-#define IDR_STR_ButtonPressed	IDR_RSRC_BNP
-#define IDR_STR_ButtonDisabled	IDR_RSRC_BND
-#define IDR_STR_GrassBlade		IDR_RSRC_TGB
-#define IDR_STR_GrassSeamless	IDR_RSRC_TSG
-#define IDR_STR_Dirt			IDR_RSRC_TDT
-#define IDR_STR_SunPainting		IDR_RSRC_TSP
-#define IDR_STR_GuitarLoop		IDR_RSRC_SGL
-#define IDR_STR_SndClick		IDR_RSRC_SDC
-#define IDR_STR_SndHover		IDR_RSRC_SDH
-
+
+
+#ifndef IDC_STATIC
+#define IDC_STATIC (-1)
+#endif
+
+#define IDR_RSRC_GR1			101
+#define IDR_RSRC_GR2			102
+#define IDR_RSRC_GR3			103
+#define IDR_RSRC_GNM			104
+#define IDR_RSRC_MIN			105
+#define IDR_RSRC_MOV			106
+#define IDR_RSRC_MNT			107
+#define IDR_RSRC_MSO			108
+#define IDR_RSRC_MTR			109
+#define IDR_RSRC_MTB			110
+#define IDR_RSRC_MCT			111
+#define IDR_RSRC_MDG			112
+#define IDR_RSRC_MRB			113
+#define IDR_RSRC_MHL			114
+#define IDR_RSRC_BNI			115
+#define IDR_RSRC_BNA			116
+#define IDR_RSRC_BNP			117
+#define IDR_RSRC_BND			118
+#define IDR_RSRC_TGB			119
+#define IDR_RSRC_TSG			120
+#define IDR_RSRC_TDT			121
+#define IDR_RSRC_TSP			122
+#define IDR_RSRC_SGL			123
+#define IDR_RSRC_SDC			124
+#define IDR_RSRC_SDH			125
+
+#define IDR_STR_Grass1			IDR_RSRC_GR1
+#define IDR_STR_Grass2			IDR_RSRC_GR2
+#define IDR_STR_Grass3			IDR_RSRC_GR3
+#define IDR_STR_Gnome			IDR_RSRC_GNM
+#define IDR_STR_MowerMini		IDR_RSRC_MIN
+#define IDR_STR_MowerMover		IDR_RSRC_MOV
+#define IDR_STR_MowerMonster	IDR_RSRC_MNT
+#define IDR_STR_Ornament		IDR_RSRC_MSO
+#define IDR_STR_Tree			IDR_RSRC_MTR
+#define IDR_STR_TreeBeehive		IDR_RSRC_MTB
+#define IDR_STR_Cat				IDR_RSRC_MCT
+#define IDR_STR_Dog				IDR_RSRC_MDG
+#define IDR_STR_RabbitHelper	IDR_RSRC_MRB
+#define IDR_STR_MoleHill		IDR_RSRC_MHL
+#define IDR_STR_ButtonInactive	IDR_RSRC_BNI
+#define IDR_STR_ButtonActive	IDR_RSRC_BNA
+#define IDR_STR_ButtonPressed	IDR_RSRC_BNP
+#define IDR_STR_ButtonDisabled	IDR_RSRC_BND
+#define IDR_STR_GrassBlade		IDR_RSRC_TGB
+#define IDR_STR_GrassSeamless	IDR_RSRC_TSG
+#define IDR_STR_Dirt			IDR_RSRC_TDT
+#define IDR_STR_SunPainting		IDR_RSRC_TSP
+#define IDR_STR_GuitarLoop		IDR_RSRC_SGL
+#define IDR_STR_SndClick		IDR_RSRC_SDC
+#define IDR_STR_SndHover		IDR_RSRC_SDH
+